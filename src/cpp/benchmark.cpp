@@ -0,0 +1,961 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+// Include STL
+#include <iostream> // cout
+#include <cstdlib> // malloc, free, aligned_alloc
+#include <cstddef> // size_t
+#include <new> // new, delete, std::bad_alloc
+#include <chrono> // steady_clock
+#include <vector> // vector
+#include <random> // mt19937
+#include <memory_resource> // monotonic_buffer_resource, unsynchronized_pool_resource
+#include <vector> // pmr::vector
+#include <string> // pmr::string
+#include <unordered_map> // pmr::unordered_map
+#include <thread> // thread
+#include <algorithm> // shuffle
+#include <cstring> // memset
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+// Include linear_depot
+#include "linear_depot.hpp"
+
+// Include linear_atomic_pool
+#include "linear_atomic_pool.hpp"
+
+// Include linear_owned_pool
+#include "linear_owned_pool.hpp"
+
+// Include linear_sharded_pool
+#include "linear_sharded_pool.hpp"
+
+#endif // MULTITHREADING
+
+// Include linear_allocator
+#include "linear_allocator.hpp"
+
+// Include linear_resource
+#include "linear_resource.hpp"
+
+// Include linear_small_allocator
+#include "linear_small_allocator.hpp"
+
+// Include linear_memory
+#include "linear_memory.hpp"
+
+// ===========================================================
+// Global heap
+// ===========================================================
+
+/* Number of calls to the global heap (operator new) */
+static std::size_t heap_calls_ = 0;
+
+/*
+ * Replaced global operator new, counts calls to the global heap.
+ *
+ * (?) Array & nothrow forms call this one by default.
+*/
+void * operator new( std::size_t pSize )
+{
+
+	// Count call
+	heap_calls_++;
+
+	// Allocate
+	void *const ptr_( std::malloc( pSize > 0 ? pSize : 1 ) );
+
+	// Check allocation
+	if ( ptr_ == nullptr )
+		throw std::bad_alloc( );
+
+	// Return pointer
+	return( ptr_ );
+
+}
+
+/* Replaced global operator delete */
+void operator delete( void * ptr_ ) noexcept
+{ std::free( ptr_ ); }
+
+/* Replaced global sized operator delete */
+void operator delete( void * ptr_, std::size_t ) noexcept
+{ std::free( ptr_ ); }
+
+/*
+ * Replaced global aligned operator new, counts calls to the global heap.
+ *
+ * (?) std::pmr::new_delete_resource calls aligned form.
+*/
+void * operator new( std::size_t pSize, std::align_val_t pAlign )
+{
+
+	// Count call
+	heap_calls_++;
+
+	// Allocate, aligned_alloc requires size multiple of alignment
+	const std::size_t align_( static_cast<std::size_t>( pAlign ) );
+	void *const ptr_( std::aligned_alloc( align_, ( ( pSize > 0 ? pSize : 1 ) + align_ - 1 ) / align_ * align_ ) );
+
+	// Check allocation
+	if ( ptr_ == nullptr )
+		throw std::bad_alloc( );
+
+	// Return pointer
+	return( ptr_ );
+
+}
+
+/* Replaced global aligned operator delete */
+void operator delete( void * ptr_, std::align_val_t ) noexcept
+{ std::free( ptr_ ); }
+
+/* Replaced global sized aligned operator delete */
+void operator delete( void * ptr_, std::size_t, std::align_val_t ) noexcept
+{ std::free( ptr_ ); }
+
+// ===========================================================
+// Utils
+// ===========================================================
+
+/* Benchmark clock */
+using bench_clock = std::chrono::steady_clock;
+
+/* Prevents compiler from removing benchmarked code */
+static void * volatile sink_ = nullptr;
+
+/* Returns nanoseconds per operation since the given time-point */
+static double ns_per_op( const bench_clock::time_point & pStart, const std::size_t pOps )
+{ return( std::chrono::duration<double, std::nano>( bench_clock::now( ) - pStart ).count( ) / static_cast<double>( pOps ) ); }
+
+/* Prints benchmark result */
+static void print_result( const char *const pName, const double pNs, const std::size_t pHeapCalls )
+{ std::cout << pName << ": " << pNs << " ns/op; heap calls=" << pHeapCalls << std::endl; }
+
+// ===========================================================
+// Benchmarks
+// ===========================================================
+
+/*
+ * Allocate/deallocate pairs.
+ *
+ * (?) linear_allocator must not call the global heap after construction.
+*/
+static void allocate_deallocate_benchmark( )
+{
+
+	// Iterations
+	constexpr std::size_t ITERATIONS = 10000000;
+
+	// Create linear_allocator instance
+	linear_allocator<double> allocator_( 256 );
+
+	// Reset heap calls counter
+	heap_calls_ = 0;
+
+	// Start
+	bench_clock::time_point start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+
+		// Allocate 1 object
+		double *const ptr_ = allocator_.allocate( );
+		sink_ = ptr_;
+
+		// Deallocate
+		allocator_.deallocate( ptr_ );
+
+	}
+
+	// Print result
+	print_result( "linear_allocator allocate/deallocate", ns_per_op( start_, ITERATIONS ), heap_calls_ );
+
+	// Reset heap calls counter
+	heap_calls_ = 0;
+
+	// Start
+	start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+
+		// Allocate 1 object
+		double *const ptr_ = new double( );
+		sink_ = ptr_;
+
+		// Deallocate
+		delete ptr_;
+
+	}
+
+	// Print result
+	print_result( "operator new/delete", ns_per_op( start_, ITERATIONS ), heap_calls_ );
+
+}
+
+/*
+ * Allocation latency of the given mode, from empty pool to 99% full.
+ *
+ * (?) Pool is filled from the first block, then 2 blocks are allocated & deallocated
+ * in loop, so bitmap mode has to search after the last freed block is reused.
+*/
+static void fill_level_benchmark( const linear_allocator_mode pMode, const char *const pName )
+{
+
+	// Iterations
+	constexpr std::size_t ITERATIONS = 1000000;
+
+	// Pool size
+	constexpr std::size_t COUNT = 16384;
+
+	// Fill levels in percents
+	const std::size_t levels_[] = { 0, 25, 50, 75, 90, 99 };
+
+	for ( const std::size_t level_ : levels_ )
+	{
+
+		// Create linear_allocator instance
+		linear_allocator<double> allocator_( COUNT, pMode );
+
+		// Fill pool
+		std::vector<double*> reserved_( COUNT * level_ / 100 );
+		for ( double *& ptr_ : reserved_ )
+			ptr_ = allocator_.allocate( );
+
+		// Start
+		const bench_clock::time_point start_ = bench_clock::now( );
+
+		for ( std::size_t i = 0; i < ITERATIONS; i++ )
+		{
+
+			// Allocate 2 objects
+			double *const first_ = allocator_.allocate( );
+			double *const second_ = allocator_.allocate( );
+			sink_ = first_;
+			sink_ = second_;
+
+			// Deallocate
+			allocator_.deallocate( second_ );
+			allocator_.deallocate( first_ );
+
+		}
+
+		// Print result
+		std::cout << pName << " " << level_ << "% full: " << ns_per_op( start_, ITERATIONS * 2 ) << " ns/allocation" << std::endl;
+
+		// Release
+		for ( double *const ptr_ : reserved_ )
+			allocator_.deallocate( ptr_ );
+
+	}
+
+}
+
+/*
+ * Bitmap search in a full bitmap with random churn.
+ *
+ * (?) All bits are set, then random bit is reset & searched again,
+ * so flat scan has to walk half of the words on average.
+*/
+template <bool SUMMARY>
+static void bitmap_benchmark( const std::size_t pBits, const char *const pName )
+{
+
+	// Iterations
+	constexpr std::size_t ITERATIONS = 2000;
+
+	// Create bitmap
+	linear_bitmap<SUMMARY> bitmap_( pBits );
+
+	// Fill bitmap
+	for ( std::size_t i = 0; i < pBits; i++ )
+		bitmap_.set( i );
+
+	// Random bits
+	std::mt19937_64 random_( 777 );
+	std::vector<std::size_t> indices_( ITERATIONS );
+	for ( std::size_t & index_ : indices_ )
+		index_ = random_( ) % pBits;
+
+	// Found bits sum
+	std::size_t sum_ = 0;
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	for ( const std::size_t index_ : indices_ )
+	{
+
+		// Release random bit
+		bitmap_.reset( index_ );
+
+		// Search & reserve it again
+		const std::size_t found_ = bitmap_.find_first_zero( );
+		bitmap_.set( found_ );
+		sum_ += found_;
+
+	}
+
+	// Print result
+	std::cout << pName << ": " << ns_per_op( start_, ITERATIONS ) << " ns/search" << std::endl;
+	sink_ = reinterpret_cast<void*>( sum_ );
+
+}
+
+/* Releases memory of monotonic resources between rounds */
+template <typename R>
+static void release_resource( R & pResource )
+{ pResource.release( ); }
+
+/* Pool resource releases memory on deallocation */
+static void release_resource( linear_pool_resource & )
+{ }
+
+/*
+ * pmr containers on the given resource.
+ *
+ * (?) Each round fills containers & destroys them, then resource is released.
+ * - vector - push_back without reserve, buffer grows geometrically.
+ * - unordered_map - node insert & erase churn.
+ * - string - strings, longer than small-string buffer.
+*/
+template <typename R>
+static void pmr_benchmark( R & pResource, const char *const pName )
+{
+
+	// Rounds
+	constexpr std::size_t ROUNDS = 1000;
+
+	// Elements per round
+	constexpr std::size_t COUNT = 1000;
+
+	// Reset heap calls counter
+	heap_calls_ = 0;
+
+	// Start
+	bench_clock::time_point start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ROUNDS; i++ )
+	{
+		{
+			std::pmr::vector<int> vector_( &pResource );
+			for ( std::size_t j = 0; j < COUNT; j++ )
+				vector_.push_back( static_cast<int>( j ) );
+			sink_ = vector_.data( );
+		}
+		release_resource( pResource );
+	}
+
+	// Print result
+	std::cout << pName << " ";
+	print_result( "pmr::vector push_back", ns_per_op( start_, ROUNDS * COUNT ), heap_calls_ );
+
+	// Reset heap calls counter
+	heap_calls_ = 0;
+
+	// Start
+	start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ROUNDS; i++ )
+	{
+		{
+			std::pmr::unordered_map<int, int> map_( COUNT, &pResource );
+			for ( std::size_t j = 0; j < COUNT; j++ )
+				map_.emplace( static_cast<int>( j ), static_cast<int>( j ) );
+			for ( std::size_t j = 0; j < COUNT; j += 2 )
+				map_.erase( static_cast<int>( j ) );
+			for ( std::size_t j = 0; j < COUNT; j += 2 )
+				map_.emplace( static_cast<int>( j ), static_cast<int>( j ) );
+			sink_ = &map_;
+		}
+		release_resource( pResource );
+	}
+
+	// Print result
+	std::cout << pName << " ";
+	print_result( "pmr::unordered_map insert/erase", ns_per_op( start_, ROUNDS * COUNT * 2 ), heap_calls_ );
+
+	// Reset heap calls counter
+	heap_calls_ = 0;
+
+	// Start
+	start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ROUNDS; i++ )
+	{
+		{
+			std::pmr::vector<std::pmr::string> strings_( &pResource );
+			strings_.reserve( COUNT );
+			for ( std::size_t j = 0; j < COUNT; j++ )
+				strings_.emplace_back( 40, static_cast<char>( 'a' + j % 26 ) );
+			sink_ = strings_.data( );
+		}
+		release_resource( pResource );
+	}
+
+	// Print result
+	std::cout << pName << " ";
+	print_result( "pmr::string", ns_per_op( start_, ROUNDS * COUNT ), heap_calls_ );
+
+}
+
+/*
+ * linear resources vs standard pmr resources.
+ *
+ * (?) Pool slot fits unordered_map node & 41 bytes string, larger buffers go upstream.
+*/
+static void pmr_resources_benchmark( )
+{
+
+	// Arena & monotonic buffer size
+	constexpr std::size_t SIZE = 1 << 20;
+
+	// linear_pool_resource
+	{
+		linear_pool_resource resource_( 64, 4096 );
+		pmr_benchmark( resource_, "linear_pool_resource" );
+	}
+
+	// linear_arena_resource
+	{
+		linear_arena_resource resource_( SIZE );
+		pmr_benchmark( resource_, "linear_arena_resource" );
+	}
+
+	// monotonic_buffer_resource
+	{
+		std::pmr::monotonic_buffer_resource resource_( SIZE );
+		pmr_benchmark( resource_, "monotonic_buffer_resource" );
+	}
+
+	// unsynchronized_pool_resource
+	{
+		std::pmr::unsynchronized_pool_resource resource_;
+		pmr_benchmark( resource_, "unsynchronized_pool_resource" );
+	}
+
+}
+
+/*
+ * Mixed sizes churn: linear_small_allocator vs malloc/free.
+ *
+ * (?) Random live block is replaced by block of random size from 8 to 1024 bytes,
+ * sizes & slots are generated before timing.
+*/
+static void small_allocator_benchmark( )
+{
+
+	// Iterations & live blocks
+	constexpr std::size_t ITERATIONS = 4000000;
+	constexpr std::size_t LIVE = 4096;
+
+	// Random sizes & slots
+	std::mt19937 random_( 42 );
+	std::uniform_int_distribution<std::size_t> size_( 8, linear_small_allocator::MAX_SIZE );
+	std::vector<std::size_t> sizes_( ITERATIONS );
+	std::vector<std::size_t> slots_( ITERATIONS );
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		sizes_[i] = size_( random_ );
+		slots_[i] = random_( ) % LIVE;
+	}
+
+	// Live blocks & sizes
+	std::vector<void*> blocks_( LIVE, nullptr );
+	std::vector<std::size_t> blockSizes_( LIVE, 0 );
+
+	{
+		// Create linear_small_allocator instance
+		linear_small_allocator allocator_;
+
+		// Reset heap calls counter
+		heap_calls_ = 0;
+
+		// Start
+		const bench_clock::time_point start_ = bench_clock::now( );
+
+		for ( std::size_t i = 0; i < ITERATIONS; i++ )
+		{
+			const std::size_t slot_( slots_[i] );
+			allocator_.deallocate( blocks_[slot_], blockSizes_[slot_] );
+			blocks_[slot_] = allocator_.allocate( sizes_[i] );
+			blockSizes_[slot_] = sizes_[i];
+		}
+
+		// Print result
+		print_result( "linear_small_allocator mixed sizes", ns_per_op( start_, ITERATIONS ), heap_calls_ );
+
+		// Release live blocks
+		for ( std::size_t i = 0; i < LIVE; i++ )
+		{
+			allocator_.deallocate( blocks_[i], blockSizes_[i] );
+			blocks_[i] = nullptr;
+		}
+	}
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		const std::size_t slot_( slots_[i] );
+		std::free( blocks_[slot_] );
+		blocks_[slot_] = std::malloc( sizes_[i] );
+	}
+
+	// Print result
+	print_result( "malloc/free mixed sizes", ns_per_op( start_, ITERATIONS ), 0 );
+
+	// Release live blocks
+	for ( std::size_t i = 0; i < LIVE; i++ )
+		std::free( blocks_[i] );
+
+}
+
+/* Node of the random walk, one block of 64 bytes */
+struct walk_node
+{
+	walk_node * next_;
+	unsigned char padding_[56];
+};
+
+/*
+ * Random walk over blocks of a large pool with the given pages policy.
+ *
+ * (?) Blocks are linked in random order, so almost every step misses TLB with
+ * regular pages. Huge page covers 512 regular pages with one TLB entry.
+*/
+static void huge_page_benchmark( const linear_allocator_pages pPages, const char *const pName )
+{
+
+	// Blocks (256 MiB) & steps
+	constexpr std::size_t COUNT = 4 * 1024 * 1024;
+	constexpr std::size_t ITERATIONS = 20000000;
+
+	// Create linear_allocator instance
+	linear_allocator<walk_node> allocator_( COUNT, linear_allocator_mode::free_list, linear_allocator_growth::none, 0, linear_allocator_commit::eager, pPages );
+
+	// Link all blocks in random order
+	std::vector<walk_node*> nodes_( COUNT );
+	for ( walk_node *& node_ : nodes_ )
+		node_ = allocator_.allocate( );
+	std::shuffle( nodes_.begin( ), nodes_.end( ), std::mt19937( 42 ) );
+	for ( std::size_t i = 0; i < COUNT; i++ )
+		nodes_[i]->next_ = nodes_[( i + 1 ) % COUNT];
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	// Walk
+	walk_node * node_( nodes_[0] );
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+		node_ = node_->next_;
+	sink_ = node_;
+
+	// Print result
+	std::cout << "random walk " << pName << ": " << ns_per_op( start_, ITERATIONS ) << " ns/step; huge slabs=" << allocator_.huge_slabs_count( ) << "; huge bytes=" << allocator_.huge_bytes( ) / ( 1024 * 1024 ) << " MiB" << std::endl;
+
+	// Release
+	for ( walk_node *const block_ : nodes_ )
+		allocator_.deallocate( block_ );
+
+}
+
+/*
+ * First allocations of a fresh pool, with & without prefault.
+ *
+ * (?) Each block is written after allocation, as constructor would do. Minor faults
+ * of the thread are counted around the loop, prefaulted pool must show 0.
+ *
+ * @param pPrepare - function, called with the pool before allocations.
+*/
+template <typename F>
+static void prefault_benchmark( const linear_allocator_commit pCommit, const char *const pName, F pPrepare )
+{
+
+	// Blocks (64 MiB)
+	constexpr std::size_t COUNT = 1024 * 1024;
+
+	// Create linear_pool instance
+	linear_pool pool_( 64, COUNT, linear_allocator_mode::free_list, linear_allocator_growth::none, 64, pCommit );
+	std::vector<void*> blocks_( COUNT, nullptr );
+	pPrepare( pool_ );
+
+	// Start
+	const std::size_t faults_( linear_minor_faults( ) );
+	const bench_clock::time_point start_ = bench_clock::now( );
+	double max_( 0 );
+
+	for ( std::size_t i = 0; i < COUNT; i++ )
+	{
+
+		// Allocate & write
+		const bench_clock::time_point allocation_start_ = bench_clock::now( );
+		blocks_[i] = std::memset( pool_.allocate( ), 1, 64 );
+		const double ns_( std::chrono::duration<double, std::nano>( bench_clock::now( ) - allocation_start_ ).count( ) );
+		max_ = ns_ > max_ ? ns_ : max_;
+
+	}
+
+	// Print result
+	const double ns_( ns_per_op( start_, COUNT ) );
+	std::cout << "first touch " << pName << ": " << ns_ << " ns/allocation; max=" << max_ << " ns; minor faults=" << linear_minor_faults( ) - faults_ << std::endl;
+
+	// Release
+	for ( void *const block_ : blocks_ )
+		pool_.deallocate( block_ );
+
+}
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/* Runs the given function in the given number of threads & returns nanoseconds per operation */
+template <typename F>
+static double threads_ns_per_op( const std::size_t pThreads, const std::size_t pOps, F pFunction )
+{
+
+	// Threads
+	std::vector<std::thread> threads_;
+	threads_.reserve( pThreads );
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	// Run threads
+	for ( std::size_t i = 0; i < pThreads; i++ )
+		threads_.emplace_back( pFunction );
+
+	// Wait
+	for ( std::thread & thread_ : threads_ )
+		thread_.join( );
+
+	// Return time
+	return( ns_per_op( start_, pOps * pThreads ) );
+
+}
+
+/*
+ * Allocate/deallocate bursts from 1 to 8 threads: magazines vs locked depot.
+ *
+ * (?) Each thread allocates a burst of blocks & releases them, so magazine
+ * goes to the depot once per half of magazine.
+*/
+static void depot_benchmark( )
+{
+
+	// Iterations per thread
+	constexpr std::size_t ITERATIONS = 200000;
+
+	// Burst size
+	constexpr std::size_t BURST = 8;
+
+	for ( std::size_t threads_ = 1; threads_ <= 8; threads_ *= 2 )
+	{
+
+		// Magazines
+		{
+			linear_depot depot_( sizeof( double ), 4096 );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&depot_]( )
+			{
+				linear_depot::magazine magazine_( depot_ );
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = magazine_.allocate( );
+					for ( void *const block_ : blocks_ )
+						magazine_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_depot magazines " << threads_ << " threads: " << ns_ << " ns/op; transfers=" << depot_.transfers( ) << std::endl;
+		}
+
+		// Locked depot
+		{
+			linear_depot depot_( sizeof( double ), 4096 );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&depot_]( )
+			{
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = depot_.allocate( );
+					for ( void *const block_ : blocks_ )
+						depot_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_depot locked " << threads_ << " threads: " << ns_ << " ns/op" << std::endl;
+		}
+
+	}
+
+}
+
+/*
+ * Contention of shared pools without thread caches, from 1 to 8 threads:
+ * lock-free free-list & atomic bitmap vs locked depot.
+ *
+ * (?) In free_list mode every allocation & deallocation goes to the shared head,
+ * in bitmap mode threads start search at different words.
+*/
+static void atomic_pool_benchmark( )
+{
+
+	// Iterations per thread
+	constexpr std::size_t ITERATIONS = 200000;
+
+	// Burst size
+	constexpr std::size_t BURST = 8;
+
+	for ( std::size_t threads_ = 1; threads_ <= 8; threads_ *= 2 )
+	{
+
+		// Lock-free free-list
+		{
+			linear_atomic_pool pool_( sizeof( double ), 4096 );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&pool_]( )
+			{
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = pool_.allocate( );
+					for ( void *const block_ : blocks_ )
+						pool_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_atomic_pool free_list " << threads_ << " threads: " << ns_ << " ns/op" << std::endl;
+		}
+
+		// Atomic bitmap
+		{
+			linear_atomic_pool pool_( sizeof( double ), 4096, linear_allocator_mode::bitmap );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&pool_]( )
+			{
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = pool_.allocate( );
+					for ( void *const block_ : blocks_ )
+						pool_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_atomic_pool bitmap " << threads_ << " threads: " << ns_ << " ns/op" << std::endl;
+		}
+
+		// Locked depot
+		{
+			linear_depot depot_( sizeof( double ), 4096 );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&depot_]( )
+			{
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = depot_.allocate( );
+					for ( void *const block_ : blocks_ )
+						depot_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_depot locked " << threads_ << " threads: " << ns_ << " ns/op" << std::endl;
+		}
+
+	}
+
+}
+
+/*
+ * Producer-consumer: objects are allocated by one thread & freed by 1 to 8 other threads,
+ * owned pool with remote-free queue vs lock-free shared free-list.
+ *
+ * (?) Each round owner allocates all blocks, then workers free own parts concurrently.
+ * Owned pool drains remote frees on the next round allocations.
+*/
+template <typename P>
+static void remote_free_round( P & pPool, std::vector<void*> & pBlocks, const std::size_t pThreads )
+{
+
+	// Allocate all blocks
+	for ( void *& block_ : pBlocks )
+		block_ = pPool.allocate( );
+
+	// Free parts of blocks in workers
+	std::vector<std::thread> threads_;
+	const std::size_t part_( pBlocks.size( ) / pThreads );
+	for ( std::size_t i = 0; i < pThreads; i++ )
+	{
+		threads_.emplace_back( [&pPool, &pBlocks, part_, i]( )
+		{
+			for ( std::size_t j = i * part_; j < ( i + 1 ) * part_; j++ )
+				pPool.deallocate( pBlocks[j] );
+		} );
+	}
+
+	// Wait
+	for ( std::thread & thread_ : threads_ )
+		thread_.join( );
+
+}
+
+/* Producer-consumer rounds on both pools */
+static void remote_free_benchmark( )
+{
+
+	// Rounds
+	constexpr std::size_t ROUNDS = 50;
+
+	// Blocks count
+	constexpr std::size_t COUNT = 1 << 16;
+
+	// Blocks of the round
+	std::vector<void*> blocks_( COUNT );
+
+	for ( std::size_t threads_ = 1; threads_ <= 8; threads_ *= 2 )
+	{
+
+		// Owned pool with remote-free queue
+		{
+			linear_owned_pool pool_( sizeof( double ), COUNT );
+			const bench_clock::time_point start_ = bench_clock::now( );
+			for ( std::size_t i = 0; i < ROUNDS; i++ )
+				remote_free_round( pool_, blocks_, threads_ );
+			std::cout << "linear_owned_pool remote frees " << threads_ << " threads: " << ns_per_op( start_, ROUNDS * COUNT * 2 ) << " ns/op; drains=" << pool_.drains( ) << std::endl;
+		}
+
+		// Lock-free shared free-list
+		{
+			linear_atomic_pool pool_( sizeof( double ), COUNT );
+			const bench_clock::time_point start_ = bench_clock::now( );
+			for ( std::size_t i = 0; i < ROUNDS; i++ )
+				remote_free_round( pool_, blocks_, threads_ );
+			std::cout << "linear_atomic_pool shared frees " << threads_ << " threads: " << ns_per_op( start_, ROUNDS * COUNT * 2 ) << " ns/op" << std::endl;
+		}
+
+	}
+
+}
+
+/*
+ * Per-CPU shards vs one shared lock-free free-list, from 1 to 8 threads.
+ *
+ * (?) Same memory for both pools: shared pool has all blocks of the shards.
+*/
+static void sharded_pool_benchmark( )
+{
+
+	// Iterations per thread
+	constexpr std::size_t ITERATIONS = 200000;
+
+	// Burst size
+	constexpr std::size_t BURST = 8;
+
+	// Blocks count of each shard
+	constexpr std::size_t COUNT = 1024;
+
+	for ( std::size_t threads_ = 1; threads_ <= 8; threads_ *= 2 )
+	{
+
+		// Per-CPU shards
+		{
+			linear_sharded_pool pool_( sizeof( double ), COUNT );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&pool_]( )
+			{
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = pool_.allocate( );
+					for ( void *const block_ : blocks_ )
+						pool_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_sharded_pool " << pool_.shards_count( ) << " shards " << threads_ << " threads: " << ns_ << " ns/op; steals=" << pool_.steals( ) << std::endl;
+		}
+
+		// Shared free-list
+		{
+			linear_atomic_pool pool_( sizeof( double ), COUNT * std::thread::hardware_concurrency( ) );
+			const double ns_ = threads_ns_per_op( threads_, ITERATIONS * BURST, [&pool_]( )
+			{
+				void * blocks_[BURST];
+				for ( std::size_t i = 0; i < ITERATIONS; i++ )
+				{
+					for ( void *& block_ : blocks_ )
+						block_ = pool_.allocate( );
+					for ( void *const block_ : blocks_ )
+						pool_.deallocate( block_ );
+				}
+			} );
+			std::cout << "linear_atomic_pool shared " << threads_ << " threads: " << ns_ << " ns/op" << std::endl;
+		}
+
+	}
+
+}
+
+#endif // MULTITHREADING
+
+/* MAIN */
+int main( int argC, char** argV )
+{
+
+	// Print 'linear_allocator benchmarks' to the console
+	std::cout << "linear_allocator benchmarks" << std::endl;
+
+	// Allocate/deallocate pairs
+	allocate_deallocate_benchmark( );
+
+	// Allocation latency from empty to full pool
+	fill_level_benchmark( linear_allocator_mode::bitmap, "bitmap" );
+	fill_level_benchmark( linear_allocator_mode::free_list, "free_list" );
+
+	// Bitmap search in large full pools
+	bitmap_benchmark<false>( 1 << 20, "flat bitmap 1M" );
+	bitmap_benchmark<true>( 1 << 20, "summary bitmap 1M" );
+	bitmap_benchmark<false>( 1 << 24, "flat bitmap 16M" );
+	bitmap_benchmark<true>( 1 << 24, "summary bitmap 16M" );
+
+	// pmr resources
+	pmr_resources_benchmark( );
+
+	// Size classes
+	small_allocator_benchmark( );
+
+	// TLB misses of random access
+	huge_page_benchmark( linear_allocator_pages::normal, "regular pages" );
+	huge_page_benchmark( linear_allocator_pages::transparent_huge, "transparent huge pages" );
+	huge_page_benchmark( linear_allocator_pages::huge, "huge pages" );
+
+	// Page faults of first allocations
+	prefault_benchmark( linear_allocator_commit::eager, "eager", []( linear_pool & ) { } );
+	prefault_benchmark( linear_allocator_commit::populate, "populate", []( linear_pool & ) { } );
+	prefault_benchmark( linear_allocator_commit::eager, "eager + prefault", []( linear_pool & pPool ) { pPool.prefault( ); } );
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+	// Shared depot with per-thread magazines
+	depot_benchmark( );
+
+	// Lock-free shared pool
+	atomic_pool_benchmark( );
+
+	// Cross-thread frees
+	remote_free_benchmark( );
+
+	// Per-CPU shards
+	sharded_pool_benchmark( );
+
+	// Page faults of first allocations, after background prefault
+	prefault_benchmark( linear_allocator_commit::lazy, "lazy + background prefault", []( linear_pool & pPool ) { pPool.prefault_async( ).join( ); } );
+#endif // MULTITHREADING
+
+	// Return OK
+	return( 0 );
+
+}
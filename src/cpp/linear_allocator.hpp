@@ -5,14 +5,20 @@
  * API: C++ 11
 */
 
+#ifndef C0DE4UN_LINEAR_ALLOCATOR_HPP
+#define C0DE4UN_LINEAR_ALLOCATOR_HPP
+
 /* ALLOCATORS REQUIRED HEADERS */
 
 #include <cstdlib> // malloc & free
 #include <cstddef> // size_t
-#include <new> // new, std::bad_alloc
-#include <stdexcept> // std::length_error
-#include <bitset> // bitset
-#include <map> // map
+#include <new> // new, std::bad_alloc, std::align_val_t
+#include <stdexcept> // std::length_error, std::invalid_argument
+#include <memory> // shared_ptr
+#include <type_traits> // true_type, false_type
+#include <utility> // forward
+
+#include "linear_pool.hpp" // linear_pool
 
 #ifdef __linear_allocator_debug_enabled_ // DEBUG
 
@@ -24,9 +30,264 @@
 
 /* END OF ALLOCATORS REQUIRED HEADERS */
 
+/*
+ * linear_pool_group - pools, shared by linear_allocator copies & rebinds.
+ *
+ * (?) Each (object size, alignment) pair gets own linear_pool, created on first use
+ * with the same count, mode, growth & alignment. So container nodes, rebound
+ * from the value type, are stored in pools too.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_pool_group
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_pool_group constructor.
+	 *
+	 * @param pCount - objects limit of the first slab of each pool.
+	 * @param pMode - blocks search mode.
+	 * @param pGrowth - growth policy, when all blocks are reserved.
+	 * @param pAlignment - minimal blocks alignment, power of 2 or 0.
+	 * @param pCommit - slab memory commit policy.
+	 * @param pPages - slab pages policy.
+	 * @throws - can throw std::invalid_argument
+	*/
+	linear_pool_group( const std::size_t pCount, const linear_allocator_mode pMode, const linear_allocator_growth pGrowth, const std::size_t pAlignment, const linear_allocator_commit pCommit, const linear_allocator_pages pPages )
+		: count_( pCount ),
+		mode_( pMode ),
+		growth_( pGrowth ),
+		commit_( pCommit ),
+		pages_( pPages ),
+		alignment_( pAlignment ),
+		pools_( nullptr ),
+		poolsCount_( 0 )
+	{
+
+		// Check alignment
+		if ( ( alignment_ & ( alignment_ - 1 ) ) != 0 )
+			throw std::invalid_argument( "linear_allocator::constructor - alignment must be power of 2" );
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_pool_group destructor */
+	~linear_pool_group( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool_group::destructor; pools: " << poolsCount_ << std::endl;
+#endif // DEBUG
+
+		// Release pools
+		for ( std::size_t i = 0; i < poolsCount_; i++ )
+		{
+			pools_[i]->~linear_pool( );
+			std::free( pools_[i] );
+		}
+
+		// Release pools array
+		std::free( pools_ );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns blocks search mode */
+	linear_allocator_mode mode( ) const noexcept
+	{ return( mode_ ); }
+
+	/* Returns pools count */
+	std::size_t pools_count( ) const noexcept
+	{ return( poolsCount_ ); }
+
+	/*
+	 * Faults pages of all pools in.
+	 *
+	 * @return - populated bytes.
+	*/
+	std::size_t prefault( ) noexcept
+	{
+		std::size_t bytes_( 0 );
+		for ( std::size_t i = 0; i < poolsCount_; i++ )
+			bytes_ += pools_[i]->prefault( );
+		return( bytes_ );
+	}
+
+	/*
+	 * Returns pages of available blocks of all pools to OS.
+	 *
+	 * @return - released bytes.
+	*/
+	std::size_t release_free_pages( ) noexcept
+	{
+		std::size_t bytes_( 0 );
+		for ( std::size_t i = 0; i < poolsCount_; i++ )
+			bytes_ += pools_[i]->release_free_pages( );
+		return( bytes_ );
+	}
+
+	/*
+	 * Returns pool for the given object size & alignment, or nullptr if it wasn't created yet.
+	 *
+	 * (?) Pools count is the number of node types in use, so linear search is enough.
+	*/
+	linear_pool * find( const std::size_t pObjectSize, const std::size_t pAlignment ) const noexcept
+	{
+
+		// Blocks alignment
+		const std::size_t alignment_( block_alignment( pAlignment ) );
+
+		// Search pool
+		for ( std::size_t i = 0; i < poolsCount_; i++ )
+		{
+			if ( pools_[i]->object_size( ) == pObjectSize && pools_[i]->alignment( ) == alignment_ )
+				return( pools_[i] );
+		}
+
+		// Not found
+		return( nullptr );
+
+	}
+
+	/*
+	 * Returns pool for the given object size & alignment, creates it if required.
+	 *
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	linear_pool & pool( const std::size_t pObjectSize, const std::size_t pAlignment )
+	{
+
+		// Existing pool
+		linear_pool *const found_( find( pObjectSize, pAlignment ) );
+		if ( found_ != nullptr )
+			return( *found_ );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool_group::pool - pool #" << std::to_string( poolsCount_ ) << "; object_size=" << pObjectSize << std::endl;
+#endif // DEBUG
+
+		// Grow pools array
+		linear_pool ** pools_array_( static_cast<linear_pool**>( std::realloc( pools_, ( poolsCount_ + 1 ) * sizeof( linear_pool* ) ) ) );
+		if ( pools_array_ == nullptr )
+			throw std::bad_alloc( );
+		pools_ = pools_array_;
+
+		// Allocate pool
+		void *const memory_( std::malloc( sizeof( linear_pool ) ) );
+		if ( memory_ == nullptr )
+			throw std::bad_alloc( );
+
+		// Construct pool
+		linear_pool * pool_( nullptr );
+		try
+		{
+			pool_ = new( memory_ ) linear_pool( pObjectSize, count_, mode_, growth_, block_alignment( pAlignment ), commit_, pages_ );
+		}
+		catch ( ... )
+		{
+			std::free( memory_ );
+			throw;
+		}
+
+		// Add pool
+		pools_[poolsCount_] = pool_;
+		poolsCount_++;
+
+		// Return pool
+		return( *pool_ );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Objects limit of the first slab */
+	const std::size_t count_;
+
+	/* Blocks search mode */
+	const linear_allocator_mode mode_;
+
+	/* Growth policy */
+	const linear_allocator_growth growth_;
+
+	/* Slab memory commit policy */
+	const linear_allocator_commit commit_;
+
+	/* Slab pages policy */
+	const linear_allocator_pages pages_;
+
+	/* Minimal blocks alignment */
+	const std::size_t alignment_;
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Pools */
+	linear_pool ** pools_;
+
+	/* Pools count */
+	std::size_t poolsCount_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns blocks alignment for the given object alignment */
+	std::size_t block_alignment( const std::size_t pAlignment ) const noexcept
+	{ return( alignment_ > pAlignment ? alignment_ : pAlignment ); }
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_pool_group const copy constructor */
+	linear_pool_group( const linear_pool_group & ) = delete;
+
+	/* @deleted linear_pool_group const copy assignment operator */
+	linear_pool_group & operator=( const linear_pool_group & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
 /*
  * linear_allocator - linear allocator with fixed size.
- * 
+ *
+ * (?) Stateful allocator: copies & rebinds share one linear_pool_group, & compare equal,
+ * so memory, allocated by one of them, can be deallocated by any other.
+ * Group is released with the last allocator, which shares it.
+ *
+ * (?) Blocks are stored in slabs of linear_pool. Without growth there is only one slab,
+ * other slabs are added by growth policy & never move, so pointers stay valid.
+ *
+ * (?) Block size is rounded up to the alignment, & slab buffer starts at the alignment,
+ * so over-aligned types (SIMD vectors, padded counters) get aligned blocks.
+ *
  * @config
  * - __linear_allocator_debug_enabled_ - enable log-output using STL cout & cin.
 */
@@ -34,6 +295,12 @@ template <typename T>
 class linear_allocator
 {
 
+	// -------------------------------------------------------- \\
+
+	/* Rebound allocators share the pools group */
+	template <typename U>
+	friend class linear_allocator;
+
 private:
 
 	// -------------------------------------------------------- \\
@@ -42,8 +309,8 @@ private:
 	// Config
 	// ===========================================================
 
-	/* Objects (items) limit (max.) */
-	static constexpr std::size_t OBJECTS_LIMIT = 320;
+	/* Default objects (items) count */
+	static constexpr std::size_t DEFAULT_COUNT = 320;
 
 	// -------------------------------------------------------- \\
 
@@ -65,62 +332,97 @@ public:
 	using pointer = value_type * ;
 
 	/* const pointer type-alias for libstdc++ */
-	using const_pointer = const pointer;
+	using const_pointer = const value_type * ;
 
 	/* reference type-alias for libstdc++ */
 	using reference = value_type & ;
 
 	/* const reference type-alias for libstdc++ */
-	using const_reference = const reference;
+	using const_reference = const value_type & ;
 
 	/* size_type type-alias for libstdc++ */
 	using size_type = std::size_t;
 
+	/* Copy assignment of container copies allocator, so containers keep sharing pools */
+	using propagate_on_container_copy_assignment = std::true_type;
+
+	/* Move assignment of container moves allocator, nodes are moved without copy */
+	using propagate_on_container_move_assignment = std::true_type;
+
+	/* Swap of containers swaps allocators */
+	using propagate_on_container_swap = std::true_type;
+
+	/* Instances with different pools groups aren't equal */
+	using is_always_equal = std::false_type;
+
+	/*
+	 * Rebinds allocator to another type, required by node-based containers.
+	 *
+	 * (?) Rebound allocator shares pools group, nodes get own pool.
+	*/
+	template <typename U>
+	struct rebind
+	{
+		using other = linear_allocator<U>;
+	};
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Cache line size in bytes. Used as alignment, pads each block to a cache line to avoid false sharing. */
+	static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
 	// ===========================================================
 	// Constructors
 	// ===========================================================
 
 	/*
 	 * linear_allocator constructor.
-	 * Used to support stateless allocator.
 	 *
-	 * @param pCount_ - objects (items, elements) limit.
+	 * (?) In free_list mode block is at least size_type long, to store link to the next available block.
+	 *
+	 * @param pCount_ - objects (items, elements) limit of the first slab. Blocks status bitmap is sized for it.
+	 * @param pMode - blocks search mode.
+	 * @param pGrowth - growth policy, when all blocks are reserved.
+	 * @param pAlignment - blocks alignment, power of 2. alignof( T ) is used, when it's less or 0.
+	 * @param pCommit - slab memory commit policy.
+	 * @param pPages - slab pages policy, huge pages for large pools with random access.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
 	*/
-	linear_allocator( const std::size_t & pCount_ = OBJECTS_LIMIT )
-		: count_( pCount_ ),
-		elementSize_( sizeof( T ) ),
-		available_count_( count_ ),
-		buffer_( nullptr ),
-		blocks_status_( ),
-		reserved_blocks_indices_( ),
-		freedIndex_( 0 )
+	linear_allocator( const std::size_t & pCount_ = DEFAULT_COUNT, const linear_allocator_mode pMode = linear_allocator_mode::bitmap, const linear_allocator_growth pGrowth = linear_allocator_growth::none, const std::size_t pAlignment = 0, const linear_allocator_commit pCommit = linear_allocator_commit::eager, const linear_allocator_pages pPages = linear_allocator_pages::normal )
+		: group_( std::make_shared<linear_pool_group>( pCount_, pMode, pGrowth, pAlignment, pCommit, pPages ) ),
+		pool_( nullptr )
 	{
 
 #ifdef __linear_allocator_debug_enabled_ // DEBUG
 		// Print message
-		std::cout << "linear_allocator::constructor; elements: " << count_ << "; element_size=" << elementSize_ << "total_size=" << count_ * elementSize_ << std::endl;
+		std::cout << "linear_allocator::constructor; elements: " << pCount_ << std::endl;
 #endif // DEBUG
 
-		// Allocate buffer
-		buffer_ = static_cast<unsigned char*>( std::malloc( ( elementSize_ * count_ ) * sizeof( unsigned char ) ) );
-
-		// Check allocation
-		if ( buffer_ == nullptr )
-			throw std::bad_alloc( );
+		// Allocate first slab
+		pool_ = &group_->pool( sizeof( T ), alignof( T ) );
 
 	}
 
 	/*
 	 * linear_allocator const copy constructor, required by STL.
+	 *
+	 * (?) Copy shares pools group. There is no move constructor,
+	 * so moved-from allocator stays usable.
 	*/
-	linear_allocator( const linear_allocator & pOther )
-	{
-
-#ifdef __linear_allocator_debug_enabled_ // DEBUG
-		// Print message
-		std::cout << "linear_allocator::const copy constructor" << std::endl;
-#endif // DEBUG
+	linear_allocator( const linear_allocator & pOther ) noexcept = default;
 
+	/*
+	 * linear_allocator converting constructor, required by STL to rebind.
+	 *
+	 * (?) Pool for T is created on the first allocation.
+	*/
+	template <typename U>
+	linear_allocator( const linear_allocator<U> & pOther ) noexcept
+		: group_( pOther.group_ ),
+		pool_( nullptr )
+	{
 	}
 
 	// ===========================================================
@@ -128,18 +430,7 @@ public:
 	// ===========================================================
 
 	/* linear_allocator destructor */
-	~linear_allocator( )
-	{
-
-#ifdef __linear_allocator_debug_enabled_ // DEBUG
-		// Print message
-		std::cout << "linear_allocator::destructor" << std::endl;
-#endif // DEBUG
-
-		// Release buffer
-		std::free( buffer_ );
-
-	}
+	~linear_allocator( ) = default;
 
 	// ===========================================================
 	// Methods
@@ -169,181 +460,174 @@ public:
 	const size_type max_size( ) const noexcept
 	{ return( static_cast<std::size_t>( -1 ) / sizeof( T ) ); }
 
-	/* Returns available blocks count */
+	/* Returns available blocks count of T pool */
 	const size_type available_size( ) const noexcept
-	{ return( available_count_ ); }
+	{
+		const linear_pool *const pool_( find_pool( ) );
+		return( pool_ != nullptr ? pool_->available_size( ) : 0 );
+	}
 
-	/* Returns reserved blocks count */
+	/* Returns reserved blocks count of T pool */
 	const size_type reserved_size( ) const noexcept
-	{ return( count_ - available_count_ ); }
+	{
+		const linear_pool *const pool_( find_pool( ) );
+		return( pool_ != nullptr ? pool_->reserved_size( ) : 0 );
+	}
+
+	/* Returns slabs count of T pool */
+	const size_type slabs_count( ) const noexcept
+	{
+		const linear_pool *const pool_( find_pool( ) );
+		return( pool_ != nullptr ? pool_->slabs_count( ) : 0 );
+	}
+
+	/* Returns count of T pool slabs, which got huge pages policy */
+	const size_type huge_slabs_count( ) const noexcept
+	{
+		const linear_pool *const pool_( find_pool( ) );
+		return( pool_ != nullptr ? pool_->huge_slabs_count( ) : 0 );
+	}
+
+	/* Returns resident bytes of T pool, backed by huge pages. Reads /proc/self/smaps. */
+	const size_type huge_bytes( ) const noexcept
+	{
+		const linear_pool *const pool_( find_pool( ) );
+		return( pool_ != nullptr ? pool_->huge_bytes( ) : 0 );
+	}
+
+	/*
+	 * Faults pages of all pools in the group in, so allocations don't page-fault.
+	 *
+	 * (?) Pools of rebound types, created later, aren't prefaulted, populate commit policy covers them.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @return - populated bytes.
+	*/
+	size_type prefault( ) noexcept
+	{ return( group_->prefault( ) ); }
+
+	/*
+	 * Returns pages of available blocks of all pools in the group to OS.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @return - released bytes.
+	*/
+	size_type release_free_pages( ) noexcept
+	{ return( group_->release_free_pages( ) ); }
 
 	/*
 	 * Allocates given amount of objects (elements)
 	 * & returns pointer to first element.
-	 * 
+	 *
+	 * (?) Several objects are placed into the first run of contiguous available blocks (bitmap mode only).
+	 * In free_list mode they are allocated with global operator new, like arrays of containers buckets.
+	 *
+	 * (?) When all blocks are reserved, another slab is added by growth policy.
+	 *
 	 * @thread_safety - not thread-safe.
 	 * @param pCount - number of elements (size, count).
-	 * @throws - can throw std::bad_alloc
+	 * @throws - can throw std::bad_alloc & std::length_error
 	*/
 	T * allocate( const size_type pCount = 1, const void *const = 0 )
 	{
-		
-#ifdef __linear_allocator_debug_enabled_ // DEBUG
-		// Print message
-		std::cout << "linear_allocator::allocate - allocating " << pCount << " objects, already allocated:" << count_ << " objects." << std::endl;
-#endif // DEBUG
-
-		// Check if exceeded
-		if ( available_count_ < 1 )
-			throw std::length_error( "linear_allocator::allocate - maximum objects exceeded" );
-
-		// Check allocation-size
-		if ( pCount > 1 )
-			throw std::length_error( "linear_allocator::allocate - this allocator supports only one object allocation at once" );
-		else if ( pCount < 1 )
-			return( nullptr );
-
-		// Decrease available blocks counter
-		available_count_ -= pCount;
-		
-		// Search Available block
-		if ( freedIndex_ > 0 )
-		{
-
-			// Check if last freed block still available
-			if ( !blocks_status_.test( freedIndex_ ) )
-			{// Available
-
-				// Pointer (address, offset) to the block
-				void *const ptr_( buffer_ + ( freedIndex_ * elementSize_ ) );
-
-#ifdef __linear_allocator_debug_enabled_ // DEBUG
-		// Print message
-				std::cout << "linear_allocator::allocate - reserving again, lately freed block #" << std::to_string( freedIndex_ ) << " ; address=" << ptr_ << std::endl;
-#endif // DEBUG
-
-				// Reserve
-				blocks_status_.set( freedIndex_, true );
-
-				// Add index to the reserved blocks map
-				reserved_blocks_indices_[static_cast<const void *const>( ptr_ )] = freedIndex_;
-
-				// Reset last freed block
-				freedIndex_ = 0;
 
-				// Return pointer to the offset-address
-				return( static_cast<pointer>( ptr_ ) );
+		// Pool of T
+		linear_pool & pool_( pool( ) );
 
-			}
-			else // Somehow block got reserved.
-				freedIndex_ = 0;
-		}
-
-		// Block index
-		size_type i = 0;
-		
-		// Search available block
-		while ( i < count_ )
+		// Several objects in free_list mode
+		if ( pCount > 1 && pool_.mode( ) == linear_allocator_mode::free_list )
 		{
 
-			// Check block status
-			if ( !blocks_status_.test( i ) )
-			{// Available
-
-				// Pointer (address, offset) to the block
-				void *const ptr_( buffer_ + ( freedIndex_ * elementSize_ ) );
-
-#ifdef __linear_allocator_debug_enabled_ // DEBUG
-		// Print message
-				std::cout << "linear_allocator::allocate - reserving block #" << std::to_string( i ) << " ; address=" << ptr_ << std::endl;
-#endif // DEBUG
-
-				// Reserve
-				blocks_status_.set( i, true );
+			// Check if exceeded
+			if ( pCount > max_size( ) )
+				throw std::length_error( "linear_allocator::allocate - maximum objects exceeded" );
 
-				// Add index to the reserved blocks map
-				reserved_blocks_indices_[static_cast<const void *const>( ptr_ )] = i;
-
-				// Return pointer to the offset-address
-				return( static_cast<pointer>( ptr_ ) );
-
-			}
-
-			// Next
-			i++;
+			// Allocate from the global heap
+			if ( pool_.alignment( ) > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+				return( static_cast<pointer>( ::operator new( pCount * sizeof( T ), std::align_val_t( pool_.alignment( ) ) ) ) );
+			return( static_cast<pointer>( ::operator new( pCount * sizeof( T ) ) ) );
 
 		}
 
-		// Throw bad_alloc
-		throw std::bad_alloc( );
+		// Allocate from the pool
+		return( static_cast<pointer>( pool_.allocate( pCount ) ) );
 
 	}
 
 	/*
 	 * Deallocate.
 	 *
-	 * (!) This method calls destructor. Don't use the given object.
-	 *
-	 * (!) This allocator supports only one block (address, pointer) allocation/deallocation
-	 * at one time, to provide alignment of memory & fast access.
+	 * (!) Objects aren't destroyed, call destroy first, like STL containers do.
 	 *
 	 * @param ptr_ - pointer/offset to the block of memory.
 	 * @param size_ - number of objects (blocks) to deallocate from
-	 * the given offset (pointer, address).
+	 * the given offset (pointer, address), same as allocated.
 	*/
 	void deallocate( pointer ptr_, const size_type size_ = 1 )
 	{
 
-		// Destroy
-		destroy( ptr_ );
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
 
-		// Get block index
-		const size_type & index_ = reserved_blocks_indices_[static_cast<const void *const>( ptr_ )];
+		// Pool of T
+		linear_pool & pool_( pool( ) );
 
-#ifdef __linear_allocator_debug_enabled_ // DEBUG
-		// Print message
-		std::cout << "linear_allocator::deallocate - freeing block #" << std::to_string( index_ ) << std::endl;
-#endif // DEBUG
+		// Several objects in free_list mode
+		if ( size_ > 1 && pool_.mode( ) == linear_allocator_mode::free_list )
+		{
 
-		// Mark block as available
-		blocks_status_.set( index_, false );
-		freedIndex_ = index_;
+			// Release to the global heap
+			if ( pool_.alignment( ) > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+				::operator delete( ptr_, std::align_val_t( pool_.alignment( ) ) );
+			else
+				::operator delete( ptr_ );
+			return;
 
-		// Remove block index from reserved map
-		reserved_blocks_indices_.erase( static_cast<const void *const>( ptr_ ) );
+		}
 
-		// Increase available blocks counter
-		available_count_ += size_;
+		// Release to the pool
+		pool_.deallocate( ptr_, size_ );
 
 	}
 
-	template <typename... _Args>
-	void construct( const_pointer ptr_, _Args&&... args_ )
+	template <typename U, typename... _Args>
+	void construct( U * ptr_, _Args&&... args_ )
 	{
-		new( (void*) ptr_ ) T( std::forward<_Args>( args_ )... );
+		new( (void*) ptr_ ) U( std::forward<_Args>( args_ )... );
 	}
-	
-	void destroy( pointer ptr_ )
+
+	template <typename U>
+	void destroy( U * ptr_ )
 	{
-		ptr_->~T( );
+		ptr_->~U( );
 	}
 
 	// ===========================================================
 	// Operators
 	// ===========================================================
 
-	/* Compare linear_allocators */
-	const bool operator!=( const linear_allocator & pOther ) const noexcept
-	{ return( *this != pOther ); }
+	/*
+	 * linear_allocator const copy assignment operator.
+	 *
+	 * (?) There is no move assignment operator, so moved-from allocator stays usable.
+	*/
+	linear_allocator & operator=( const linear_allocator & pOther ) noexcept = default;
 
 	/*
 	 * Returns 'TRUE' if this storage allocator can be deallocated
 	 * from the other allocator, and other-way also (vise versa).
-	 * 
-	 * @return - 'TRUE', because this is stateless allocator.
+	 *
+	 * @return - 'TRUE', if both allocators share pools group.
 	*/
-	const bool operator==( const linear_allocator & pOther ) const noexcept
-	{ return( true ); }
+	template <typename U>
+	const bool operator==( const linear_allocator<U> & pOther ) const noexcept
+	{ return( group_ == pOther.group_ ); }
+
+	/* Compare linear_allocators */
+	template <typename U>
+	const bool operator!=( const linear_allocator<U> & pOther ) const noexcept
+	{ return( !( *this == pOther ) ); }
 
 	// -------------------------------------------------------- \\
 
@@ -352,59 +636,42 @@ private:
 	// -------------------------------------------------------- \\
 
 	// ===========================================================
-	// Constants
+	// Fields
 	// ===========================================================
 
-	/* Elements (items, blocks) count */
-	const std::size_t count_;
-
-	/* Max. (limit) number of objects */
-	//const std::size_t objectsLimit_;
-
-	/* Size (length) in bytes of the element (item, object) */
-	const std::size_t elementSize_;
+	/* Pools, shared with copies & rebinds */
+	std::shared_ptr<linear_pool_group> group_;
 
-	/* Total size in bytes [count * size]. Can't be exceeded. */
-	//const std::size_t sizeLimit_;
+	/* Pool of T, nullptr until the first allocation of rebound allocator */
+	linear_pool * pool_;
 
 	// ===========================================================
-	// Fields
+	// Methods
 	// ===========================================================
 
-	/* Number of available blocks (items, objects). */
-	std::size_t available_count_;
-
-	/* Buffer */
-	unsigned char * buffer_;
-
-	/*
-	 * Cache to store blocks status.
-	*/
-	std::bitset<OBJECTS_LIMIT> blocks_status_;
-
-	/*
-	 * Last freed block index.
-	*/
-	size_type freedIndex_;
-
 	/*
-	 * Map to store reserved blocks indices.
+	 * Returns pool of T, creates it if required.
 	 *
-	 * Allows to release specific block fast, knowing
-	 * only pointer (address of the block, offset).
+	 * @throws - can throw std::bad_alloc & std::length_error
 	*/
-	std::map<const void*const, size_type> reserved_blocks_indices_;
+	linear_pool & pool( )
+	{
 
-	// ===========================================================
-	// Deleted
-	// ===========================================================
+		// Pool of rebound allocator
+		if ( pool_ == nullptr )
+			pool_ = &group_->pool( sizeof( T ), alignof( T ) );
 
-	/* @deleted linear_allocator const copy assignment operator */
-	linear_allocator & operator=( const linear_allocator & ) = delete;
+		// Return pool
+		return( *pool_ );
 
-	/* @deleted linear_allocator move assignment operator */
-	linear_allocator & operator=( linear_allocator && ) = delete;
+	}
+
+	/* Returns pool of T, or nullptr if it wasn't created yet */
+	const linear_pool * find_pool( ) const noexcept
+	{ return( pool_ != nullptr ? pool_ : group_->find( sizeof( T ), alignof( T ) ) ); }
 
 	// -------------------------------------------------------- \\
 
-};
\ No newline at end of file
+};
+
+#endif // !C0DE4UN_LINEAR_ALLOCATOR_HPP
\ No newline at end of file
@@ -0,0 +1,202 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_ARENA_HPP
+#define C0DE4UN_LINEAR_ARENA_HPP
+
+/* ARENA REQUIRED HEADERS */
+
+#include <cstddef> // size_t, max_align_t
+#include <cstdint> // uintptr_t
+#include <stdexcept> // std::length_error
+
+#include "linear_buffer.hpp" // linear_buffer
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF ARENA REQUIRED HEADERS */
+
+/*
+ * linear_arena - bump-pointer allocator.
+ *
+ * (?) Allocation moves offset forward with alignment, deallocation does nothing.
+ * Memory is released all at once with reset, or back to the marker with rewind.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_arena
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* Arena state, returned by mark & accepted by rewind */
+	using marker = std::size_t;
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_arena constructor.
+	 *
+	 * @param pSize - size in bytes.
+	 * @throws - can throw std::bad_alloc
+	*/
+	explicit linear_arena( const std::size_t pSize )
+		: buffer_( pSize ),
+		offset_( 0 )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_arena::constructor; size=" << pSize << std::endl;
+#endif // DEBUG
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns size in bytes */
+	std::size_t capacity( ) const noexcept
+	{ return( buffer_.size( ) ); }
+
+	/* Returns used bytes count, including alignment padding */
+	std::size_t used( ) const noexcept
+	{ return( offset_ ); }
+
+	/* Returns available bytes count */
+	std::size_t available( ) const noexcept
+	{ return( buffer_.size( ) - offset_ ); }
+
+	/*
+	 * Allocates bytes.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - size in bytes.
+	 * @param pAlign - alignment, power of 2.
+	 * @throws - can throw std::length_error, when arena is exhausted.
+	*/
+	void * allocate( const std::size_t pSize, const std::size_t pAlign = alignof( std::max_align_t ) )
+	{
+
+		// Allocate
+		void *const ptr_( try_allocate( pSize, pAlign ) );
+
+		// Check if exceeded
+		if ( ptr_ == nullptr )
+			throw std::length_error( "linear_arena::allocate - arena size exceeded" );
+
+		// Return pointer
+		return( ptr_ );
+
+	}
+
+	/*
+	 * Allocates bytes, returns nullptr when arena is exhausted.
+	 *
+	 * (?) Used by callers with own fallback, so exhausted arena doesn't cost an exception per allocation.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - size in bytes.
+	 * @param pAlign - alignment, power of 2.
+	*/
+	void * try_allocate( const std::size_t pSize, const std::size_t pAlign = alignof( std::max_align_t ) ) noexcept
+	{
+
+		// Aligned offset
+		const std::uintptr_t address_( reinterpret_cast<std::uintptr_t>( buffer_.data( ) ) + offset_ );
+		const std::size_t offset_aligned_( offset_ + static_cast<std::size_t>( ( ( address_ + pAlign - 1 ) & ~static_cast<std::uintptr_t>( pAlign - 1 ) ) - address_ ) );
+
+		// Check if exceeded
+		if ( offset_aligned_ > buffer_.size( ) || pSize > buffer_.size( ) - offset_aligned_ )
+			return( nullptr );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_arena::allocate - " << pSize << " bytes at offset " << offset_aligned_ << std::endl;
+#endif // DEBUG
+
+		// Bump
+		offset_ = offset_aligned_ + pSize;
+
+		// Return pointer
+		return( buffer_.data( ) + offset_aligned_ );
+
+	}
+
+	/*
+	 * Deallocate.
+	 *
+	 * (?) Does nothing, use rewind or reset.
+	*/
+	void deallocate( void *const, const std::size_t = 0 ) noexcept
+	{ }
+
+	/* Returns 'TRUE' if the given pointer is inside arena buffer */
+	bool owns( const void *const ptr_ ) const noexcept
+	{ return( static_cast<const unsigned char*>( ptr_ ) >= buffer_.data( ) && static_cast<const unsigned char*>( ptr_ ) < buffer_.data( ) + buffer_.size( ) ); }
+
+	/* Returns current state, to rewind later */
+	marker mark( ) const noexcept
+	{ return( offset_ ); }
+
+	/*
+	 * Releases everything, allocated after the marker.
+	 *
+	 * (!) Marker must be taken from this arena after the last reset.
+	*/
+	void rewind( const marker pMarker ) noexcept
+	{ offset_ = pMarker; }
+
+	/* Releases everything at once */
+	void reset( ) noexcept
+	{ offset_ = 0; }
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Buffer */
+	linear_buffer buffer_;
+
+	/* Offset of the first available byte */
+	std::size_t offset_;
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_arena const copy constructor */
+	linear_arena( const linear_arena & ) = delete;
+
+	/* @deleted linear_arena const copy assignment operator */
+	linear_arena & operator=( const linear_arena & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_ARENA_HPP
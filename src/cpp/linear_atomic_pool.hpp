@@ -0,0 +1,527 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_ATOMIC_POOL_HPP
+#define C0DE4UN_LINEAR_ATOMIC_POOL_HPP
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/* ATOMIC POOL REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free
+#include <cstddef> // size_t, max_align_t
+#include <cstdint> // uint32_t, uint64_t
+#include <new> // new, std::bad_alloc
+#include <stdexcept> // std::length_error, std::invalid_argument, std::logic_error
+#include <atomic> // atomic
+
+#include "linear_buffer.hpp" // linear_buffer
+#include "linear_bitmap.hpp" // linear_bitmap_ctz
+#include "linear_pool.hpp" // linear_allocator_mode
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF ATOMIC POOL REQUIRED HEADERS */
+
+/*
+ * linear_atomic_pool - lock-free pool of fixed size blocks, shared by threads.
+ *
+ * (?) In free_list mode available blocks are linked into Treiber stack. Head is one 64-bit word:
+ * 32-bit block index & 32-bit tag, incremented by every push & pop, so single CAS
+ * detects ABA, when head was popped & pushed back between load & CAS.
+ *
+ * (?) Links are stored in separate array of atomic indices, not inside blocks,
+ * so thread, which reads link of just popped block, doesn't race with its owner.
+ *
+ * (?) Blocks, which never were reserved, aren't linked: they are taken by atomic
+ * increment of the untouched index, when free-list is empty. So construction doesn't
+ * write all links, & pages of large pool aren't touched until blocks are used.
+ *
+ * (?) In bitmap mode occupancy is array of atomic 64-bit words. Zero bit is found
+ * with ctz & claimed with fetch_or, block is released with fetch_and. Each thread
+ * starts search at own word, so threads don't claim bits of the same word.
+ * Bitmap keeps occupancy queries: reserved blocks are counted with popcount.
+ *
+ * (?) Pool doesn't grow, slabs can't be added without lock.
+ *
+ * @config
+ * - _C0DE4UN_MULTITHREADING_ENABLED_ - required, pool isn't defined without it.
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_atomic_pool
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Cache line size in bytes, head is isolated to own cache line */
+	static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+	/* Invalid block index, used as end of free-list. Also limits blocks count. */
+	static constexpr std::uint32_t NO_INDEX = static_cast<std::uint32_t>( -1 );
+
+	/* Bits count in the bitmap word */
+	static constexpr std::size_t WORD_BITS = 64;
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_atomic_pool constructor.
+	 *
+	 * @param pObjectSize - object size in bytes.
+	 * @param pCount - blocks count, less than NO_INDEX.
+	 * @param pMode - blocks search mode.
+	 * @param pAlignment - blocks alignment, power of 2.
+	 * @param pNode - NUMA node of the buffer pages, LINEAR_NUMA_NO_NODE for default placement.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
+	*/
+	linear_atomic_pool( const std::size_t pObjectSize, const std::size_t pCount, const linear_allocator_mode pMode = linear_allocator_mode::free_list, const std::size_t pAlignment = alignof( std::max_align_t ), const int pNode = LINEAR_NUMA_NO_NODE )
+		: mode_( pMode ),
+		count_( check_count( pCount ) ),
+		elementSize_( block_size( pObjectSize, pAlignment ) ),
+		wordsCount_( ( count_ + WORD_BITS - 1 ) / WORD_BITS ),
+		buffer_( count_ * elementSize_, pAlignment, pNode ),
+		links_( nullptr ),
+		words_( nullptr ),
+		head_( NO_INDEX ),
+		untouched_( 0 )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_atomic_pool::constructor; elements: " << count_ << "; element_size=" << elementSize_ << std::endl;
+#endif // DEBUG
+
+		// Allocate links or bitmap
+		if ( mode_ == linear_allocator_mode::free_list )
+			links_ = static_cast<std::atomic<std::uint32_t>*>( std::malloc( count_ * sizeof( std::atomic<std::uint32_t> ) ) );
+		else
+			words_ = static_cast<std::atomic<std::uint64_t>*>( std::malloc( wordsCount_ * sizeof( std::atomic<std::uint64_t> ) ) );
+
+		// Check allocation
+		if ( links_ == nullptr && words_ == nullptr )
+			throw std::bad_alloc( );
+
+		// Construct bitmap, links are constructed when block is reserved first time
+		if ( mode_ == linear_allocator_mode::bitmap )
+		{
+			for ( size_type i = 0; i < wordsCount_; i++ )
+				new( words_ + i ) std::atomic<std::uint64_t>( 0 );
+		}
+
+		// All blocks are available
+		reset( );
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_atomic_pool destructor */
+	~linear_atomic_pool( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_atomic_pool::destructor" << std::endl;
+#endif // DEBUG
+
+		// Release links & bitmap
+		std::free( links_ );
+		std::free( words_ );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns blocks search mode */
+	linear_allocator_mode mode( ) const noexcept
+	{ return( mode_ ); }
+
+	/* Returns blocks count */
+	size_type capacity( ) const noexcept
+	{ return( count_ ); }
+
+	/* Returns buffer address */
+	const unsigned char * data( ) const noexcept
+	{ return( buffer_.data( ) ); }
+
+	/* Returns NUMA node of the buffer, or LINEAR_NUMA_NO_NODE */
+	int node( ) const noexcept
+	{ return( buffer_.node( ) ); }
+
+	/*
+	 * Returns reserved blocks count.
+	 *
+	 * (!) Snapshot, blocks can be allocated & deallocated by other threads during count.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @throws - can throw std::logic_error in free_list mode, links can't be counted while threads change them.
+	*/
+	size_type reserved_size( ) const
+	{
+
+		// Check mode
+		if ( mode_ != linear_allocator_mode::bitmap )
+			throw std::logic_error( "linear_atomic_pool::reserved_size - supported in bitmap mode only" );
+
+		// Count reserved bits
+		size_type count_reserved_ = 0;
+		for ( size_type i = 0; i < wordsCount_; i++ )
+			count_reserved_ += popcount( words_[i].load( std::memory_order_relaxed ) );
+
+		// Padding bits of the last word are always set
+		return( count_reserved_ - ( wordsCount_ * WORD_BITS - count_ ) );
+
+	}
+
+	/*
+	 * Releases all blocks at once.
+	 *
+	 * @thread_safety - not thread-safe, no allocation or deallocation can run concurrently.
+	*/
+	void reset( ) noexcept
+	{
+
+		// Bitmap mode
+		if ( mode_ == linear_allocator_mode::bitmap )
+		{
+
+			// Clear words
+			for ( size_type i = 0; i < wordsCount_; i++ )
+				words_[i].store( 0, std::memory_order_relaxed );
+
+			// Set padding bits, so they are never claimed
+			if ( count_ % WORD_BITS != 0 )
+				words_[wordsCount_ - 1].store( ~std::uint64_t( 0 ) << ( count_ % WORD_BITS ), std::memory_order_relaxed );
+
+		}
+		else
+		{
+
+			// Empty free-list, all blocks are untouched
+			head_.store( NO_INDEX, std::memory_order_relaxed );
+			untouched_.store( 0, std::memory_order_relaxed );
+
+		}
+
+	}
+
+	/* Returns 'TRUE' if the given pointer is inside pool buffer */
+	bool owns( const void *const ptr_ ) const noexcept
+	{ return( static_cast<const unsigned char*>( ptr_ ) >= buffer_.data( ) && static_cast<const unsigned char*>( ptr_ ) < buffer_.data( ) + count_ * elementSize_ ); }
+
+	/*
+	 * Allocates 1 block.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @throws - can throw std::length_error, when all blocks are reserved.
+	*/
+	void * allocate( )
+	{
+
+		// Pop block
+		void *const ptr_( try_allocate( ) );
+
+		// Check if exceeded
+		if ( ptr_ == nullptr )
+			throw std::length_error( "linear_atomic_pool::allocate - maximum objects exceeded" );
+
+		// Return pointer
+		return( ptr_ );
+
+	}
+
+	/*
+	 * Allocates 1 block, returns nullptr when all blocks are reserved.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	*/
+	void * try_allocate( ) noexcept
+	{
+
+		// Bitmap mode
+		if ( mode_ == linear_allocator_mode::bitmap )
+			return( claim_bit( ) );
+
+		// Current head
+		std::uint64_t head_value_( head_.load( std::memory_order_acquire ) );
+
+		for ( ;; )
+		{
+
+			// Head block, or untouched block when free-list is empty
+			const std::uint32_t index_( static_cast<std::uint32_t>( head_value_ ) );
+			if ( index_ == NO_INDEX )
+				return( claim_untouched( ) );
+
+			// Next block becomes head, tag changes even if the same index comes back
+			const std::uint64_t next_( ( ( head_value_ >> 32 ) + 1 ) << 32 | links_[index_].load( std::memory_order_relaxed ) );
+
+			// Claim head block
+			if ( head_.compare_exchange_weak( head_value_, next_, std::memory_order_acquire, std::memory_order_acquire ) )
+				return( buffer_.data( ) + static_cast<size_type>( index_ ) * elementSize_ );
+
+		}
+
+	}
+
+	/*
+	 * Deallocates 1 block.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @param ptr_ - block of this pool.
+	*/
+	void deallocate( void *const ptr_ ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Block index from the offset
+		const std::uint32_t index_( static_cast<std::uint32_t>( static_cast<size_type>( static_cast<unsigned char*>( ptr_ ) - buffer_.data( ) ) / elementSize_ ) );
+
+		// Bitmap mode, release bit
+		if ( mode_ == linear_allocator_mode::bitmap )
+		{
+			words_[index_ / WORD_BITS].fetch_and( ~( std::uint64_t( 1 ) << ( index_ % WORD_BITS ) ), std::memory_order_release );
+			return;
+		}
+
+		// Current head
+		std::uint64_t head_value_( head_.load( std::memory_order_relaxed ) );
+
+		// Link block before head & make it head
+		std::uint64_t next_;
+		do
+		{
+			links_[index_].store( static_cast<std::uint32_t>( head_value_ ), std::memory_order_relaxed );
+			next_ = ( ( head_value_ >> 32 ) + 1 ) << 32 | index_;
+		}
+		while ( !head_.compare_exchange_weak( head_value_, next_, std::memory_order_release, std::memory_order_relaxed ) );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Blocks search mode */
+	const linear_allocator_mode mode_;
+
+	/* Blocks count */
+	const std::size_t count_;
+
+	/* Size (length) in bytes of the element (item, block) */
+	const std::size_t elementSize_;
+
+	/* Bitmap words count */
+	const std::size_t wordsCount_;
+
+	/* Buffer */
+	linear_buffer buffer_;
+
+	/* Next available block index of each block (free_list mode) */
+	std::atomic<std::uint32_t> * links_;
+
+	/* Blocks status bitmap, set bit is reserved block (bitmap mode) */
+	std::atomic<std::uint64_t> * words_;
+
+	/*
+	 * Free-list head: tag in upper 32 bits, block index in lower 32 bits.
+	 *
+	 * (?) Head & untouched index are the last fields & aligned to cache line, so pool size
+	 * is padded to cache line too, & they don't share cache line with other data.
+	*/
+	alignas( CACHE_LINE_SIZE ) std::atomic<std::uint64_t> head_;
+
+	/* Index of the first block, which never was reserved (free_list mode) */
+	std::atomic<std::uint64_t> untouched_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns blocks count, if it can be addressed by 32-bit index */
+	static std::size_t check_count( const std::size_t pCount )
+	{
+
+		// Check if exceeded
+		if ( pCount >= NO_INDEX )
+			throw std::length_error( "linear_atomic_pool::constructor - objects count is too big" );
+
+		// Return blocks count
+		return( pCount > 0 ? pCount : 1 );
+
+	}
+
+	/* Returns set bits count of the word */
+	static size_type popcount( std::uint64_t pWord ) noexcept
+	{
+
+		// Clear lowest set bit, until word is empty
+		size_type count_ = 0;
+		for ( ; pWord != 0; pWord &= pWord - 1 )
+			count_++;
+
+		// Return bits count
+		return( count_ );
+
+	}
+
+	/*
+	 * Returns search start word of the calling thread.
+	 *
+	 * (?) Threads get sequential numbers on the first call, multiplied by golden ratio,
+	 * so neighbour threads start far from each other, whatever words count is.
+	*/
+	size_type start_word( ) const noexcept
+	{
+
+		// Threads counter
+		static std::atomic<std::uint64_t> threads_( 0 );
+
+		// Number of the calling thread
+		static thread_local const std::uint64_t thread_( threads_.fetch_add( 1, std::memory_order_relaxed ) );
+
+		// Spread
+		return( static_cast<size_type>( ( thread_ * 0x9E3779B97F4A7C15ULL ) >> 32 ) % wordsCount_ );
+
+	}
+
+	/*
+	 * Claims block, which never was reserved, & constructs its link (free_list mode).
+	 *
+	 * (?) Link is constructed by the only thread, which owns the block, before
+	 * the block can be deallocated.
+	 *
+	 * @return - block, or nullptr when all blocks are reserved.
+	*/
+	void * claim_untouched( ) noexcept
+	{
+
+		// All blocks were reserved, don't increment index further
+		if ( untouched_.load( std::memory_order_relaxed ) >= count_ )
+			return( nullptr );
+
+		// Claim index
+		const std::uint64_t index_( untouched_.fetch_add( 1, std::memory_order_relaxed ) );
+		if ( index_ >= count_ )
+			return( nullptr );
+
+		// Construct link
+		new( links_ + index_ ) std::atomic<std::uint32_t>( NO_INDEX );
+
+		// Return block
+		return( buffer_.data( ) + static_cast<size_type>( index_ ) * elementSize_ );
+
+	}
+
+	/*
+	 * Claims available bit in the bitmap & returns its block (bitmap mode).
+	 *
+	 * (?) Zero bit is found with ctz on the loaded word, & claimed with fetch_or.
+	 * If other thread claimed it first, search continues with the returned word.
+	 *
+	 * @return - block, or nullptr when all blocks are reserved.
+	*/
+	void * claim_bit( ) noexcept
+	{
+
+		// First word of the calling thread
+		const size_type start_( start_word( ) );
+
+		for ( size_type i = 0; i < wordsCount_; i++ )
+		{
+
+			// Word index
+			const size_type word_index_( start_ + i < wordsCount_ ? start_ + i : start_ + i - wordsCount_ );
+
+			// Search zero bits of the word
+			std::uint64_t word_( words_[word_index_].load( std::memory_order_relaxed ) );
+			while ( ~word_ != 0 )
+			{
+
+				// Zero bit
+				const std::uint64_t bit_( std::uint64_t( 1 ) << linear_bitmap_ctz( ~word_ ) );
+
+				// Claim bit
+				word_ = words_[word_index_].fetch_or( bit_, std::memory_order_acquire );
+				if ( ( word_ & bit_ ) == 0 )
+					return( buffer_.data( ) + ( word_index_ * WORD_BITS + linear_bitmap_ctz( bit_ ) ) * elementSize_ );
+
+			}
+
+		}
+
+		// All blocks are reserved
+		return( nullptr );
+
+	}
+
+	/*
+	 * Returns block size in bytes, rounded up to the alignment.
+	 *
+	 * @throws - can throw std::invalid_argument
+	*/
+	static std::size_t block_size( const std::size_t pObjectSize, const std::size_t pAlignment )
+	{
+
+		// Check alignment
+		if ( pAlignment < 1 || ( pAlignment & ( pAlignment - 1 ) ) != 0 )
+			throw std::invalid_argument( "linear_atomic_pool::constructor - alignment must be power of 2" );
+
+		// Round up to the alignment
+		return( ( ( pObjectSize > 0 ? pObjectSize : 1 ) + pAlignment - 1 ) / pAlignment * pAlignment );
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_atomic_pool const copy constructor */
+	linear_atomic_pool( const linear_atomic_pool & ) = delete;
+
+	/* @deleted linear_atomic_pool const copy assignment operator */
+	linear_atomic_pool & operator=( const linear_atomic_pool & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // MULTITHREADING
+
+#endif // !C0DE4UN_LINEAR_ATOMIC_POOL_HPP
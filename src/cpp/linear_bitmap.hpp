@@ -0,0 +1,605 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_BITMAP_HPP
+#define C0DE4UN_LINEAR_BITMAP_HPP
+
+/* BITMAP REQUIRED HEADERS */
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <cstdlib> // calloc & free
+#include <new> // std::bad_alloc
+
+#include "linear_memory.hpp" // linear_populate
+
+#ifdef _MSC_VER // MSVC
+
+#include <intrin.h> // _BitScanForward64, _BitScanReverse64
+
+#endif // MSVC
+
+/* END OF BITMAP REQUIRED HEADERS */
+
+/*
+ * Returns number of trailing zero bits in the word.
+ *
+ * (!) Word must not be 0.
+*/
+inline unsigned int linear_bitmap_ctz( const std::uint64_t pWord ) noexcept
+{
+
+#if defined( _MSC_VER ) && defined( _M_X64 ) // MSVC x86-64
+	unsigned long index_;
+	_BitScanForward64( &index_, pWord );
+	return( static_cast<unsigned int>( index_ ) );
+#elif defined( _MSC_VER ) // MSVC x86-32
+	unsigned long index_;
+	if ( _BitScanForward( &index_, static_cast<unsigned long>( pWord ) ) )
+		return( static_cast<unsigned int>( index_ ) );
+	_BitScanForward( &index_, static_cast<unsigned long>( pWord >> 32 ) );
+	return( static_cast<unsigned int>( index_ ) + 32 );
+#else // GCC, Clang
+	return( static_cast<unsigned int>( __builtin_ctzll( pWord ) ) );
+#endif
+
+}
+
+/*
+ * Returns number of leading zero bits in the word.
+ *
+ * (!) Word must not be 0.
+*/
+inline unsigned int linear_bitmap_clz( const std::uint64_t pWord ) noexcept
+{
+
+#if defined( _MSC_VER ) && defined( _M_X64 ) // MSVC x86-64
+	unsigned long index_;
+	_BitScanReverse64( &index_, pWord );
+	return( 63 - static_cast<unsigned int>( index_ ) );
+#elif defined( _MSC_VER ) // MSVC x86-32
+	unsigned long index_;
+	if ( _BitScanReverse( &index_, static_cast<unsigned long>( pWord >> 32 ) ) )
+		return( 31 - static_cast<unsigned int>( index_ ) );
+	_BitScanReverse( &index_, static_cast<unsigned long>( pWord ) );
+	return( 63 - static_cast<unsigned int>( index_ ) );
+#else // GCC, Clang
+	return( static_cast<unsigned int>( __builtin_clzll( pWord ) ) );
+#endif
+
+}
+
+/*
+ * linear_bitmap - blocks status bitmap with word-at-a-time search.
+ *
+ * (?) Bit is set, when block is reserved. Search loads 64 blocks at once
+ * & jumps to the first available one with count-trailing-zeros.
+ *
+ * (?) With summary, every level above the blocks words has a bit per word
+ * of the level below, which is set when that word has an available bit.
+ * Search descends from the single top word, so it takes one ctz per level
+ * (2 for 4096 blocks, 4 for 16M blocks), whatever pool fill is.
+ *
+ * @param SUMMARY - 'TRUE' to use summary levels, 'FALSE' for flat scan.
+*/
+template <bool SUMMARY = true>
+class linear_bitmap
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Bits per word */
+	static constexpr std::size_t WORD_BITS = 64;
+
+	/* Returned by search, when there is no available bit */
+	static constexpr std::size_t NO_BIT = static_cast<std::size_t>( -1 );
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_bitmap constructor.
+	 *
+	 * (?) Bits after the given count are set, so search never returns them.
+	 *
+	 * @param pCount - bits (blocks) count.
+	 * @throws - can throw std::bad_alloc
+	*/
+	explicit linear_bitmap( const std::size_t pCount )
+		: wordsCount_( level_words( pCount ) ),
+		levels_( 0 ),
+		words_( nullptr ),
+		offsets_( ),
+		hintWord_( 0 )
+	{
+
+		// Summary levels offsets
+		std::size_t total_( wordsCount_ );
+		for ( std::size_t words_count_ = wordsCount_; SUMMARY && words_count_ > 1; words_count_ = level_words( words_count_ ) )
+		{
+			offsets_[++levels_] = total_;
+			total_ += level_words( words_count_ );
+		}
+
+		// Allocate words
+		words_ = static_cast<std::uint64_t*>( std::calloc( total_ > 0 ? total_ : 1, sizeof( std::uint64_t ) ) );
+
+		// Check allocation
+		if ( words_ == nullptr )
+			throw std::bad_alloc( );
+
+		// Every blocks word has available bits
+		if ( levels_ > 0 )
+		{
+			for ( std::size_t i = 0; i < wordsCount_; i++ )
+				set_summary( i );
+		}
+
+		// Reserve bits after count
+		for ( std::size_t i = pCount; i < wordsCount_ * WORD_BITS; i++ )
+			set( i );
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_bitmap destructor */
+	~linear_bitmap( )
+	{
+
+		// Release words
+		std::free( words_ );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns 'TRUE' if bit is set (block reserved) */
+	bool test( const std::size_t pIndex ) const noexcept
+	{ return( ( words_[pIndex / WORD_BITS] >> ( pIndex % WORD_BITS ) ) & 1 ); }
+
+	/* Sets bit (reserves block) */
+	void set( const std::size_t pIndex ) noexcept
+	{
+
+		// Blocks word
+		std::uint64_t & word_( words_[pIndex / WORD_BITS] );
+
+		// Set bit
+		word_ |= ( std::uint64_t( 1 ) << ( pIndex % WORD_BITS ) );
+
+		// Word got full
+		if ( levels_ > 0 && word_ == ~std::uint64_t( 0 ) )
+			clear_summary( pIndex / WORD_BITS );
+
+	}
+
+	/* Resets bit (releases block) */
+	void reset( const std::size_t pIndex ) noexcept
+	{
+
+		// Blocks word
+		std::uint64_t & word_( words_[pIndex / WORD_BITS] );
+
+		// Word was full
+		const bool full_( word_ == ~std::uint64_t( 0 ) );
+
+		// Reset bit
+		word_ &= ~( std::uint64_t( 1 ) << ( pIndex % WORD_BITS ) );
+
+		// Word has available bit again
+		if ( levels_ > 0 && full_ )
+			set_summary( pIndex / WORD_BITS );
+
+	}
+
+	/* Sets bits run (reserves blocks) */
+	void set_run( std::size_t pIndex, std::size_t pCount ) noexcept
+	{
+
+		while ( pCount > 0 )
+		{
+
+			// Bits in the current word
+			const std::size_t offset_( pIndex % WORD_BITS );
+			const std::size_t bits_( pCount < WORD_BITS - offset_ ? pCount : WORD_BITS - offset_ );
+
+			// Blocks word
+			std::uint64_t & word_( words_[pIndex / WORD_BITS] );
+
+			// Set bits
+			word_ |= run_mask( offset_, bits_ );
+
+			// Word got full
+			if ( levels_ > 0 && word_ == ~std::uint64_t( 0 ) )
+				clear_summary( pIndex / WORD_BITS );
+
+			// Next word
+			pIndex += bits_;
+			pCount -= bits_;
+
+		}
+
+	}
+
+	/* Resets bits run (releases blocks) */
+	void reset_run( std::size_t pIndex, std::size_t pCount ) noexcept
+	{
+
+		while ( pCount > 0 )
+		{
+
+			// Bits in the current word
+			const std::size_t offset_( pIndex % WORD_BITS );
+			const std::size_t bits_( pCount < WORD_BITS - offset_ ? pCount : WORD_BITS - offset_ );
+
+			// Blocks word
+			std::uint64_t & word_( words_[pIndex / WORD_BITS] );
+
+			// Word was full
+			const bool full_( word_ == ~std::uint64_t( 0 ) );
+
+			// Reset bits
+			word_ &= ~run_mask( offset_, bits_ );
+
+			// Word has available bits again
+			if ( levels_ > 0 && full_ )
+				set_summary( pIndex / WORD_BITS );
+
+			// Next word
+			pIndex += bits_;
+			pCount -= bits_;
+
+		}
+
+	}
+
+	/*
+	 * Faults words pages in, calloc-ed words fault on first set otherwise.
+	 *
+	 * (?) Last summary level has one word.
+	 *
+	 * @return - populated bytes.
+	*/
+	std::size_t prefault( ) noexcept
+	{ return( linear_populate( words_, ( levels_ > 0 ? offsets_[levels_] + 1 : wordsCount_ ) * sizeof( std::uint64_t ) ) ); }
+
+	/*
+	 * Searches first cleared bit (available block).
+	 *
+	 * @return - bit index, or NO_BIT if all bits are set.
+	*/
+	std::size_t find_first_zero( ) noexcept
+	{ return( levels_ > 0 ? find_summary( ) : scan( ) ); }
+
+	/*
+	 * Searches next cleared bit, starting at the given bit.
+	 *
+	 * (?) Cleared padding bits of the last word can be found, caller limits the index.
+	 *
+	 * @param pIndex - first bit to check.
+	 * @return - bit index, or NO_BIT if there is no such bit.
+	*/
+	std::size_t find_next_zero( const std::size_t pIndex ) const noexcept
+	{ return( find_next( pIndex, ~std::uint64_t( 0 ) ) ); }
+
+	/*
+	 * Searches next set bit, starting at the given bit.
+	 *
+	 * @param pIndex - first bit to check.
+	 * @return - bit index, or NO_BIT if there is no such bit.
+	*/
+	std::size_t find_next_one( const std::size_t pIndex ) const noexcept
+	{ return( find_next( pIndex, 0 ) ); }
+
+	/*
+	 * Searches first run of the given count of cleared bits (first-fit).
+	 *
+	 * (?) Inside a word, cleared bits are and-ed with themselves shifted by
+	 * doubling distance, so only starts of long enough runs stay set.
+	 * Across words, cleared high bits of the previous words are joined with
+	 * cleared low bits of the next word. Full words are skipped at once.
+	 *
+	 * (?) With summary levels, words before the first available bit are full.
+	 * Flat scan starts at the hint word, so runs are searched from the word 0.
+	 *
+	 * @param pCount - bits (blocks) count.
+	 * @return - index of the first bit in the run, or NO_BIT if there is no such run.
+	*/
+	std::size_t find_zero_run( const std::size_t pCount ) noexcept
+	{
+
+		// Available bit, words before it are full with summary levels
+		const std::size_t first_( find_first_zero( ) );
+
+		// Single bit or full
+		if ( pCount < 2 || first_ == NO_BIT )
+			return( first_ );
+
+		// Cleared bits at the end of the previous words
+		std::size_t run_ = 0;
+
+		for ( std::size_t i = levels_ > 0 ? first_ / WORD_BITS : 0; i < wordsCount_; i++ )
+		{
+
+			// Blocks word
+			const std::uint64_t word_( words_[i] );
+
+			// Whole word is available
+			if ( word_ == 0 )
+			{
+
+				run_ += WORD_BITS;
+
+				// Run is long enough
+				if ( run_ >= pCount )
+					return( ( i + 1 ) * WORD_BITS - run_ );
+
+				continue;
+
+			}
+
+			// Cleared low bits continue run of the previous words
+			if ( run_ + linear_bitmap_ctz( word_ ) >= pCount )
+				return( i * WORD_BITS - run_ );
+
+			// Run inside the word
+			if ( pCount <= WORD_BITS )
+			{
+
+				// Bit stays set, if run of the checked length starts at it
+				std::uint64_t starts_( ~word_ );
+				for ( std::size_t length_ = 1; length_ < pCount && starts_ != 0; )
+				{
+					const std::size_t shift_( length_ < pCount - length_ ? length_ : pCount - length_ );
+					starts_ &= starts_ >> shift_;
+					length_ += shift_;
+				}
+
+				// Found
+				if ( starts_ != 0 )
+					return( i * WORD_BITS + linear_bitmap_ctz( starts_ ) );
+
+			}
+
+			// Cleared high bits start new run
+			run_ = linear_bitmap_clz( word_ );
+
+		}
+
+		// Not found
+		return( NO_BIT );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Summary levels limit, enough for any 64-bit bits count */
+	static constexpr std::size_t LEVELS_LIMIT = 11;
+
+	/* Returns words count, required for the given bits (or words of the level below) */
+	static constexpr std::size_t level_words( const std::size_t pBits ) noexcept
+	{ return( pBits / WORD_BITS + ( pBits % WORD_BITS > 0 ? 1 : 0 ) ); }
+
+	/* Blocks words count */
+	const std::size_t wordsCount_;
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Summary levels count */
+	std::size_t levels_;
+
+	/* Blocks words, bit per block, followed by summary levels words */
+	std::uint64_t * words_;
+
+	/* Summary levels offsets in words */
+	std::size_t offsets_[LEVELS_LIMIT + 1];
+
+	/* Last word, which had available bits (flat scan) */
+	std::size_t hintWord_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Searches next bit, which differs from the pattern, a word at a time.
+	 *
+	 * (?) Words equal to the pattern are skipped at once.
+	 *
+	 * @param pIndex - first bit to check.
+	 * @param pPattern - word of skipped bits, all set or all cleared.
+	 * @return - bit index, or NO_BIT if there is no such bit.
+	*/
+	std::size_t find_next( const std::size_t pIndex, const std::uint64_t pPattern ) const noexcept
+	{
+
+		for ( std::size_t i = pIndex / WORD_BITS; i < wordsCount_; i++ )
+		{
+
+			// Differing bits, bits before the first one are dropped
+			std::uint64_t bits_( words_[i] ^ pPattern );
+			if ( i == pIndex / WORD_BITS )
+				bits_ &= ~std::uint64_t( 0 ) << ( pIndex % WORD_BITS );
+
+			// Found
+			if ( bits_ != 0 )
+				return( i * WORD_BITS + linear_bitmap_ctz( bits_ ) );
+
+		}
+
+		// Not found
+		return( NO_BIT );
+
+	}
+
+	/* Returns mask of the given bits count, starting at the given offset */
+	static std::uint64_t run_mask( const std::size_t pOffset, const std::size_t pBits ) noexcept
+	{ return( ( pBits < WORD_BITS ? ( std::uint64_t( 1 ) << pBits ) - 1 : ~std::uint64_t( 0 ) ) << pOffset ); }
+
+	/*
+	 * Marks word as full in the summary levels.
+	 *
+	 * (?) Goes up, while the summary word becomes empty.
+	*/
+	void clear_summary( std::size_t pWord ) noexcept
+	{
+
+		for ( std::size_t level_ = 1; level_ <= levels_; level_++ )
+		{
+
+			// Summary word
+			std::uint64_t & word_( words_[offsets_[level_] + pWord / WORD_BITS] );
+
+			// Clear bit
+			word_ &= ~( std::uint64_t( 1 ) << ( pWord % WORD_BITS ) );
+
+			// Level above still has available bit
+			if ( word_ != 0 )
+				return;
+
+			// Next level
+			pWord /= WORD_BITS;
+
+		}
+
+	}
+
+	/*
+	 * Marks word as available in the summary levels.
+	 *
+	 * (?) Goes up, while the summary word was empty.
+	*/
+	void set_summary( std::size_t pWord ) noexcept
+	{
+
+		for ( std::size_t level_ = 1; level_ <= levels_; level_++ )
+		{
+
+			// Summary word
+			std::uint64_t & word_( words_[offsets_[level_] + pWord / WORD_BITS] );
+
+			// Summary word was empty
+			const bool empty_( word_ == 0 );
+
+			// Set bit
+			word_ |= ( std::uint64_t( 1 ) << ( pWord % WORD_BITS ) );
+
+			// Level above already knows
+			if ( !empty_ )
+				return;
+
+			// Next level
+			pWord /= WORD_BITS;
+
+		}
+
+	}
+
+	/* Searches first cleared bit, descending from the top summary word */
+	std::size_t find_summary( ) const noexcept
+	{
+
+		// Word index on the current level
+		std::size_t word_ = 0;
+
+		for ( std::size_t level_ = levels_; level_ > 0; level_-- )
+		{
+
+			// Summary word
+			const std::uint64_t summary_( words_[offsets_[level_] + word_] );
+
+			// Full
+			if ( summary_ == 0 )
+				return( NO_BIT );
+
+			// Child word with available bit
+			word_ = word_ * WORD_BITS + linear_bitmap_ctz( summary_ );
+
+		}
+
+		// Available bit in the blocks word
+		return( word_ * WORD_BITS + linear_bitmap_ctz( ~words_[word_] ) );
+
+	}
+
+	/*
+	 * Searches first cleared bit, word by word.
+	 *
+	 * (?) Search starts at the last word, which had cleared bits,
+	 * & wraps around to the first word.
+	*/
+	std::size_t scan( ) noexcept
+	{
+
+		// From hint to the end
+		for ( std::size_t i = hintWord_; i < wordsCount_; i++ )
+		{
+
+			// Word has available bits
+			if ( words_[i] != ~std::uint64_t( 0 ) )
+			{
+				hintWord_ = i;
+				return( i * WORD_BITS + linear_bitmap_ctz( ~words_[i] ) );
+			}
+
+		}
+
+		// From the start to hint
+		for ( std::size_t i = 0; i < hintWord_; i++ )
+		{
+
+			// Word has available bits
+			if ( words_[i] != ~std::uint64_t( 0 ) )
+			{
+				hintWord_ = i;
+				return( i * WORD_BITS + linear_bitmap_ctz( ~words_[i] ) );
+			}
+
+		}
+
+		// Full
+		return( NO_BIT );
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_bitmap const copy constructor */
+	linear_bitmap( const linear_bitmap & ) = delete;
+
+	/* @deleted linear_bitmap const copy assignment operator */
+	linear_bitmap & operator=( const linear_bitmap & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_BITMAP_HPP
@@ -0,0 +1,453 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_BUFFER_HPP
+#define C0DE4UN_LINEAR_BUFFER_HPP
+
+/* BUFFER REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free, posix_memalign
+#include <cstddef> // size_t, max_align_t
+#include <new> // std::bad_alloc
+#include <cstdint> // uintptr_t
+
+#include "linear_numa.hpp" // linear_numa_bind
+#include "linear_memory.hpp" // linear_page_size, linear_populate, linear_huge_resident_size
+
+#ifdef _WIN32 // WINDOWS
+
+#include <malloc.h> // _aligned_malloc & _aligned_free
+
+#endif // WINDOWS
+
+#if defined( __linux__ ) // LINUX
+
+#include <sys/mman.h> // mmap, munmap, mprotect & madvise
+
+#endif // LINUX
+
+/* END OF BUFFER REQUIRED HEADERS */
+
+/*
+ * linear_allocator memory commit policy.
+ *
+ * - eager - whole buffer is allocated at construction.
+ * - lazy - address space is reserved at construction, pages are committed,
+ * as the high-water mark of used bytes grows (Linux only, eager elsewhere).
+ * - populate - whole buffer is allocated & its pages are faulted in at construction,
+ * with MAP_POPULATE on Linux, so first touch of blocks doesn't page-fault.
+*/
+enum class linear_allocator_commit : unsigned char
+{
+	eager,
+	lazy,
+	populate
+};
+
+/*
+ * linear_allocator pages policy.
+ *
+ * - normal - regular pages.
+ * - transparent_huge - buffer is aligned to LINEAR_HUGE_PAGE_SIZE & advised with MADV_HUGEPAGE.
+ * - huge - buffer is mapped with MAP_HUGETLB from reserved huge pages, transparent_huge
+ * is used, when there are no free huge pages (Linux only, normal elsewhere).
+*/
+enum class linear_allocator_pages : unsigned char
+{
+	normal,
+	transparent_huge,
+	huge
+};
+
+/*
+ * linear_buffer - backing memory of allocators.
+ *
+ * (?) Owns one contiguous buffer, allocated at construction & released at destruction.
+ * Shared by linear_allocator slabs & linear_arena.
+ *
+ * (?) Buffer, bound to NUMA node, is mapped with mmap, so its pages aren't shared
+ * with other heap data & are allocated on the node at first touch (Linux only).
+ *
+ * (?) Lazy buffer is mapped with PROT_NONE & made accessible by commit in COMMIT_STEP
+ * chunks, so unused tail of a large buffer costs address space only.
+ * Pages of mapped buffer can be returned to OS with release (Linux only).
+ *
+ * (?) prefault commits whole buffer & faults its pages in, so later first touch
+ * doesn't page-fault. Populated buffer does it at construction.
+ *
+ * (?) Huge pages buffer starts at huge page boundary & is committed & released by whole
+ * huge pages. pages tells, which policy was applied, huge_resident tells, how many bytes
+ * kernel actually backs by huge pages.
+*/
+class linear_buffer
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Bytes, committed at once by lazy buffer, multiple of page size */
+	static constexpr std::size_t COMMIT_STEP = 64 * 1024;
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_buffer constructor.
+	 *
+	 * (?) Alignment above malloc guarantee uses aligned allocation.
+	 *
+	 * @param pSize - size in bytes.
+	 * @param pAlignment - alignment of the first byte, power of 2.
+	 * @param pNode - NUMA node to bind pages to, LINEAR_NUMA_NO_NODE for default placement.
+	 * @param pCommit - commit policy.
+	 * @param pPages - pages policy.
+	 * @throws - can throw std::bad_alloc
+	*/
+	explicit linear_buffer( const std::size_t pSize, const std::size_t pAlignment = alignof( std::max_align_t ), const int pNode = LINEAR_NUMA_NO_NODE, const linear_allocator_commit pCommit = linear_allocator_commit::eager, const linear_allocator_pages pPages = linear_allocator_pages::normal )
+		: size_( pSize ),
+		alignment_( pAlignment > alignof( std::max_align_t ) ? pAlignment : 0 ),
+		data_( nullptr ),
+		mapping_( nullptr ),
+		mappingSize_( 0 ),
+		committedEnd_( nullptr ),
+		node_( LINEAR_NUMA_NO_NODE ),
+		pages_( linear_allocator_pages::normal )
+	{
+
+		// Map buffer, bound to node, committed lazily, populated or backed by huge pages
+		if ( pNode != LINEAR_NUMA_NO_NODE || pCommit != linear_allocator_commit::eager || pPages != linear_allocator_pages::normal )
+			map( pNode, pAlignment, pCommit, pPages );
+
+		// Allocate buffer
+		if ( data_ == nullptr )
+			data_ = alignment_ > 0 ? allocate_aligned( size_ > 0 ? size_ : 1, alignment_ ) : static_cast<unsigned char*>( std::malloc( ( size_ > 0 ? size_ : 1 ) * sizeof( unsigned char ) ) );
+
+		// Check allocation
+		if ( data_ == nullptr )
+			throw std::bad_alloc( );
+
+		// Whole buffer is accessible
+		if ( committedEnd_ == nullptr )
+			committedEnd_ = data_ + size_;
+
+		// Fault pages in, when buffer wasn't mapped with MAP_POPULATE
+		if ( pCommit == linear_allocator_commit::populate && mapping_ == nullptr )
+			prefault( );
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_buffer destructor */
+	~linear_buffer( )
+	{
+
+		// Release mapping
+#if defined( __linux__ ) // LINUX
+		if ( mapping_ != nullptr )
+		{
+			munmap( mapping_, mappingSize_ );
+			return;
+		}
+#endif // LINUX
+
+		// Release buffer
+#ifdef _WIN32 // WINDOWS
+		if ( alignment_ > 0 )
+			_aligned_free( data_ );
+		else
+			std::free( data_ );
+#else // POSIX
+		std::free( data_ );
+#endif // WINDOWS
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns pointer to the first byte */
+	unsigned char * data( ) const noexcept
+	{ return( data_ ); }
+
+	/* Returns size in bytes */
+	std::size_t size( ) const noexcept
+	{ return( size_ ); }
+
+	/* Returns NUMA node, pages are bound to, or LINEAR_NUMA_NO_NODE */
+	int node( ) const noexcept
+	{ return( node_ ); }
+
+	/* Returns applied pages policy, normal when huge pages weren't available */
+	linear_allocator_pages pages( ) const noexcept
+	{ return( pages_ ); }
+
+	/*
+	 * Returns resident bytes, backed by huge pages.
+	 *
+	 * (?) Reads /proc/self/smaps, not for hot path.
+	*/
+	std::size_t huge_resident( ) const noexcept
+	{ return( pages_ != linear_allocator_pages::normal ? linear_huge_resident_size( data_, size_ ) : 0 ); }
+
+	/* Returns accessible bytes from the first byte */
+	std::size_t committed( ) const noexcept
+	{ return( committedEnd_ <= data_ ? 0 : committedEnd_ > data_ + size_ ? size_ : static_cast<std::size_t>( committedEnd_ - data_ ) ); }
+
+	/*
+	 * Makes the given amount of first bytes accessible.
+	 *
+	 * (?) Lazy buffer commits up to the next COMMIT_STEP boundary, or huge page boundary,
+	 * other buffers are committed.
+	 *
+	 * @param pBytes - bytes from the first byte, which must be accessible.
+	 * @return - 'FALSE' if mprotect failed.
+	*/
+	bool commit( const std::size_t pBytes ) noexcept
+	{
+
+		// Already committed
+		if ( data_ + pBytes <= committedEnd_ )
+			return( true );
+
+#if defined( __linux__ ) // LINUX
+		// End of the chunk, limited by the mapping
+		const std::size_t step_( pages_ != linear_allocator_pages::normal ? LINEAR_HUGE_PAGE_SIZE : COMMIT_STEP );
+		unsigned char *const mapping_end_( static_cast<unsigned char*>( mapping_ ) + mappingSize_ );
+		const std::size_t offset_( ( pBytes + step_ - 1 ) / step_ * step_ );
+		unsigned char *const end_( offset_ < static_cast<std::size_t>( mapping_end_ - data_ ) ? data_ + offset_ : mapping_end_ );
+
+		// Commit
+		if ( mprotect( committedEnd_, static_cast<std::size_t>( end_ - committedEnd_ ), PROT_READ | PROT_WRITE ) != 0 )
+			return( false );
+		committedEnd_ = end_;
+		return( true );
+#else // OTHER
+		return( false );
+#endif // LINUX
+
+	}
+
+	/*
+	 * Commits whole buffer & faults its pages in for write.
+	 *
+	 * (?) Contents are kept. Pages, released later, fault again on first touch.
+	 *
+	 * @return - populated bytes, 0 if commit failed.
+	*/
+	std::size_t prefault( ) noexcept
+	{ return( commit( size_ ) ? linear_populate( data_, size_ ) : 0 ); }
+
+	/*
+	 * Returns pages, which are completely inside the given range, to OS.
+	 *
+	 * (?) Pages stay committed, next touch maps zeroed page. Huge pages buffer
+	 * releases whole huge pages only, so remaining huge pages aren't split.
+	 *
+	 * (!) Only mapped buffer releases pages, contents of the range are lost.
+	 *
+	 * @param pOffset - offset of the range in bytes.
+	 * @param pBytes - range size in bytes.
+	 * @return - released bytes.
+	*/
+	std::size_t release( const std::size_t pOffset, const std::size_t pBytes ) noexcept
+	{
+
+#if defined( __linux__ ) // LINUX
+		// Pages aren't owned
+		if ( mapping_ == nullptr )
+			return( 0 );
+
+		// Whole pages of the committed part
+		const std::uintptr_t page_( pages_ != linear_allocator_pages::normal ? LINEAR_HUGE_PAGE_SIZE : linear_page_size( ) );
+		const std::uintptr_t first_( ( reinterpret_cast<std::uintptr_t>( data_ + pOffset ) + page_ - 1 ) & ~( page_ - 1 ) );
+		const std::uintptr_t end_( reinterpret_cast<std::uintptr_t>( data_ + pOffset + pBytes ) );
+		const std::uintptr_t last_( ( end_ < reinterpret_cast<std::uintptr_t>( committedEnd_ ) ? end_ : reinterpret_cast<std::uintptr_t>( committedEnd_ ) ) & ~( page_ - 1 ) );
+		if ( last_ <= first_ )
+			return( 0 );
+
+		// Release
+		return( madvise( reinterpret_cast<void*>( first_ ), last_ - first_, MADV_DONTNEED ) == 0 ? last_ - first_ : 0 );
+#else // OTHER
+		( void ) pOffset;
+		( void ) pBytes;
+		return( 0 );
+#endif // LINUX
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Size in bytes */
+	const std::size_t size_;
+
+	/* Alignment, or 0 when buffer is allocated with malloc */
+	const std::size_t alignment_;
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Buffer */
+	unsigned char * data_;
+
+	/* Mapping, which contains aligned buffer, or nullptr when buffer isn't mapped */
+	void * mapping_;
+
+	/* Mapping size in bytes */
+	std::size_t mappingSize_;
+
+	/* End of accessible bytes */
+	unsigned char * committedEnd_;
+
+	/* NUMA node of the pages */
+	int node_;
+
+	/* Applied pages policy */
+	linear_allocator_pages pages_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Allocates aligned buffer, returns nullptr on failure */
+	static unsigned char * allocate_aligned( const std::size_t pSize, const std::size_t pAlignment ) noexcept
+	{
+
+#ifdef _WIN32 // WINDOWS
+		return( static_cast<unsigned char*>( _aligned_malloc( pSize, pAlignment ) ) );
+#else // POSIX
+		void * ptr_( nullptr );
+		return( posix_memalign( &ptr_, pAlignment, pSize ) == 0 ? static_cast<unsigned char*>( ptr_ ) : nullptr );
+#endif // WINDOWS
+
+	}
+
+	/*
+	 * Maps buffer, binds its pages to the node, reserves address space of lazy buffer
+	 * & requests huge pages.
+	 *
+	 * (?) Buffer stays unmapped, when mmap or mbind fails, so malloc is used instead.
+	 *
+	 * (?) MAP_HUGETLB mapping is made without MAP_NORESERVE, so missing huge pages
+	 * fail mmap, which falls back to transparent huge pages, instead of SIGBUS on first touch.
+	 *
+	 * (?) Populated buffer of regular or MAP_HUGETLB pages is mapped with MAP_POPULATE.
+	 * Transparent huge pages are populated after MADV_HUGEPAGE, so they are faulted in as huge.
+	 * Buffer bound to NUMA node is populated after mbind, so pages are faulted in on the node.
+	 *
+	 * @param pNode - NUMA node, or LINEAR_NUMA_NO_NODE.
+	 * @param pAlignment - alignment of the first byte, power of 2.
+	 * @param pCommit - commit policy.
+	 * @param pPages - pages policy.
+	*/
+	void map( const int pNode, const std::size_t pAlignment, const linear_allocator_commit pCommit, const linear_allocator_pages pPages ) noexcept
+	{
+
+#if defined( __linux__ ) // LINUX
+		// Page size, huge pages buffer is sized & aligned to huge pages
+		const bool lazy_( pCommit == linear_allocator_commit::lazy );
+		const bool huge_( pPages != linear_allocator_pages::normal );
+		const std::size_t page_( huge_ ? LINEAR_HUGE_PAGE_SIZE : linear_page_size( ) );
+		const std::size_t pages_size_( ( ( size_ > 0 ? size_ : 1 ) + page_ - 1 ) / page_ * page_ );
+		const int protection_( lazy_ ? PROT_NONE : PROT_READ | PROT_WRITE );
+		const bool populate_( pCommit == linear_allocator_commit::populate );
+		const int mapPopulate_( populate_ && pNode == LINEAR_NUMA_NO_NODE ? MAP_POPULATE : 0 );
+
+		// Map huge pages, mapping starts at huge page boundary
+		std::size_t extra_( 0 );
+		std::size_t mapping_size_( pages_size_ );
+		void * mapping_address_( MAP_FAILED );
+		if ( pPages == linear_allocator_pages::huge && pAlignment <= page_ )
+		{
+			mapping_address_ = mmap( nullptr, mapping_size_, protection_, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | mapPopulate_, -1, 0 );
+			if ( mapping_address_ != MAP_FAILED )
+				pages_ = linear_allocator_pages::huge;
+		}
+
+		// Map regular pages, alignment above page size needs extra space
+		if ( mapping_address_ == MAP_FAILED )
+		{
+
+			// Extra space
+			extra_ = pAlignment > page_ ? pAlignment : huge_ ? page_ : 0;
+			mapping_size_ = pages_size_ + extra_;
+
+			// Map, lazy buffer reserves address space only
+			mapping_address_ = mmap( nullptr, mapping_size_, protection_, MAP_PRIVATE | MAP_ANONYMOUS | ( lazy_ ? MAP_NORESERVE : 0 ) | ( huge_ ? 0 : mapPopulate_ ), -1, 0 );
+			if ( mapping_address_ == MAP_FAILED )
+				return;
+
+		}
+
+		// Bind pages before first touch
+		if ( pNode != LINEAR_NUMA_NO_NODE && !linear_numa_bind( mapping_address_, mapping_size_, pNode ) )
+		{
+			munmap( mapping_address_, mapping_size_ );
+			pages_ = linear_allocator_pages::normal;
+			return;
+		}
+
+		// Aligned first byte
+		const std::uintptr_t address_( reinterpret_cast<std::uintptr_t>( mapping_address_ ) );
+		data_ = reinterpret_cast<unsigned char*>( extra_ > 0 ? ( address_ + extra_ - 1 ) & ~static_cast<std::uintptr_t>( extra_ - 1 ) : address_ );
+		mapping_ = mapping_address_;
+		mappingSize_ = mapping_size_;
+		node_ = pNode;
+
+		// Transparent huge pages, kernel still can back range by regular pages
+		if ( huge_ && pages_ == linear_allocator_pages::normal && madvise( data_, pages_size_, MADV_HUGEPAGE ) == 0 )
+			pages_ = linear_allocator_pages::transparent_huge;
+
+		// Populate pages after mbind & MADV_HUGEPAGE, unless mapping is populated already
+		if ( populate_ && ( mapPopulate_ == 0 || ( huge_ && pages_ != linear_allocator_pages::huge ) ) )
+			linear_populate( data_, pages_size_ );
+
+		// Nothing is accessible yet
+		if ( lazy_ )
+			committedEnd_ = data_;
+#else // OTHER
+		( void ) pNode;
+		( void ) pAlignment;
+		( void ) pCommit;
+		( void ) pPages;
+#endif // LINUX
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_buffer const copy constructor */
+	linear_buffer( const linear_buffer & ) = delete;
+
+	/* @deleted linear_buffer const copy assignment operator */
+	linear_buffer & operator=( const linear_buffer & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_BUFFER_HPP
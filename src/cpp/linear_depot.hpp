@@ -0,0 +1,419 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_DEPOT_HPP
+#define C0DE4UN_LINEAR_DEPOT_HPP
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/* DEPOT REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free
+#include <cstddef> // size_t, max_align_t
+#include <new> // std::bad_alloc
+#include <stdexcept> // std::length_error
+#include <mutex> // mutex, lock_guard
+
+#include "linear_pool.hpp" // linear_pool
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF DEPOT REQUIRED HEADERS */
+
+/*
+ * linear_depot - linear_pool, shared by threads through per-thread magazines.
+ *
+ * (?) Each thread owns a magazine - small stack of free blocks. Magazine allocates
+ * & deallocates without locks or atomics, & goes to the depot only to refill half
+ * of the magazine when empty, or to flush half of it when full. So depot mutex
+ * is taken once per magazine_size / 2 operations, not per operation.
+ *
+ * (?) Block can be deallocated to any magazine of the same depot,
+ * not only to magazine of the allocating thread.
+ *
+ * (!) Blocks, cached by magazines, are reserved for depot, so pool without growth
+ * may be exhausted while other threads cache free blocks.
+ *
+ * @config
+ * - _C0DE4UN_MULTITHREADING_ENABLED_ - required, depot isn't defined without it.
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_depot
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Default magazine size in blocks */
+	static constexpr size_type DEFAULT_MAGAZINE_SIZE = 32;
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	 * magazine - per-thread cache of free blocks.
+	 *
+	 * (!) Magazine must be used by one thread only, & be destroyed before the depot.
+	 * Cached blocks are returned to the depot by destructor.
+	*/
+	class magazine
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructors
+		// ===========================================================
+
+		/*
+		 * magazine constructor.
+		 *
+		 * (?) Magazine is empty, first allocation refills it.
+		 *
+		 * @param pDepot - depot of blocks.
+		 * @param pSize - blocks limit, at least 2.
+		 * @throws - can throw std::bad_alloc
+		*/
+		explicit magazine( linear_depot & pDepot, const size_type pSize = DEFAULT_MAGAZINE_SIZE )
+			: depot_( pDepot ),
+			size_( pSize > 2 ? pSize : 2 ),
+			count_( 0 ),
+			blocks_( static_cast<void**>( std::malloc( size_ * sizeof( void* ) ) ) )
+		{
+
+			// Check allocation
+			if ( blocks_ == nullptr )
+				throw std::bad_alloc( );
+
+		}
+
+		// ===========================================================
+		// Destructor
+		// ===========================================================
+
+		/* magazine destructor, returns cached blocks to the depot */
+		~magazine( )
+		{
+
+			// Return cached blocks
+			flush( );
+
+			// Release blocks array
+			std::free( blocks_ );
+
+		}
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/* Returns cached blocks count */
+		size_type cached( ) const noexcept
+		{ return( count_ ); }
+
+		/*
+		 * Allocates 1 block.
+		 *
+		 * @thread_safety - owner thread only, depot is locked on refill.
+		 * @throws - can throw std::bad_alloc & std::length_error, when depot is exhausted.
+		*/
+		void * allocate( )
+		{
+
+			// Refill half of the magazine
+			if ( count_ < 1 )
+				count_ = depot_.take( blocks_, size_ / 2 );
+
+			// Pop block
+			return( blocks_[--count_] );
+
+		}
+
+		/*
+		 * Deallocates 1 block.
+		 *
+		 * @thread_safety - owner thread only, depot is locked on flush.
+		 * @param ptr_ - block, allocated from any magazine of the same depot.
+		*/
+		void deallocate( void *const ptr_ ) noexcept
+		{
+
+			// Nothing was allocated
+			if ( ptr_ == nullptr )
+				return;
+
+			// Flush upper half of the magazine, lower half stays for allocations
+			if ( count_ == size_ )
+			{
+				depot_.give( blocks_ + size_ / 2, size_ - size_ / 2 );
+				count_ = size_ / 2;
+			}
+
+			// Push block
+			blocks_[count_++] = ptr_;
+
+		}
+
+		/* Returns all cached blocks to the depot */
+		void flush( ) noexcept
+		{
+
+			// Return blocks
+			if ( count_ > 0 )
+				depot_.give( blocks_, count_ );
+
+			// Empty
+			count_ = 0;
+
+		}
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Depot */
+		linear_depot & depot_;
+
+		/* Blocks limit */
+		const size_type size_;
+
+		/* Cached blocks count */
+		size_type count_;
+
+		/* Cached blocks, used as stack */
+		void ** blocks_;
+
+		// ===========================================================
+		// Deleted
+		// ===========================================================
+
+		/* @deleted magazine const copy constructor */
+		magazine( const magazine & ) = delete;
+
+		/* @deleted magazine const copy assignment operator */
+		magazine & operator=( const magazine & ) = delete;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_depot constructor.
+	 *
+	 * @param pObjectSize - object size in bytes.
+	 * @param pCount - objects limit of the first slab.
+	 * @param pGrowth - growth policy, when all blocks are reserved.
+	 * @param pAlignment - blocks alignment, power of 2.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
+	*/
+	linear_depot( const std::size_t pObjectSize, const std::size_t pCount, const linear_allocator_growth pGrowth = linear_allocator_growth::none, const std::size_t pAlignment = alignof( std::max_align_t ) )
+		: pool_( pObjectSize, pCount, linear_allocator_mode::free_list, pGrowth, pAlignment ),
+		refills_( 0 ),
+		flushes_( 0 )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_depot::constructor; object_size=" << pObjectSize << "; elements: " << pCount << std::endl;
+#endif // DEBUG
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns blocks count, available in the depot.
+	 *
+	 * (?) Blocks, cached by magazines, aren't included.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	size_type available_size( )
+	{
+		std::lock_guard<std::mutex> lock_( mutex_ );
+		return( pool_.available_size( ) );
+	}
+
+	/*
+	 * Returns blocks count, reserved by magazines & their owners.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	size_type reserved_size( )
+	{
+		std::lock_guard<std::mutex> lock_( mutex_ );
+		return( pool_.reserved_size( ) );
+	}
+
+	/*
+	 * Returns number of refills & flushes, which locked the depot.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	size_type transfers( )
+	{
+		std::lock_guard<std::mutex> lock_( mutex_ );
+		return( refills_ + flushes_ );
+	}
+
+	/*
+	 * Allocates 1 block from the depot, without magazine.
+	 *
+	 * @thread_safety - thread-safe, depot is locked.
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	void * allocate( )
+	{
+		std::lock_guard<std::mutex> lock_( mutex_ );
+		return( pool_.allocate( ) );
+	}
+
+	/*
+	 * Deallocates 1 block to the depot, without magazine.
+	 *
+	 * @thread_safety - thread-safe, depot is locked.
+	*/
+	void deallocate( void *const ptr_ ) noexcept
+	{
+		std::lock_guard<std::mutex> lock_( mutex_ );
+		pool_.deallocate( ptr_ );
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Blocks */
+	linear_pool pool_;
+
+	/* Guards pool & counters */
+	std::mutex mutex_;
+
+	/* Number of refills */
+	size_type refills_;
+
+	/* Number of flushes */
+	size_type flushes_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Takes batch of blocks for magazine refill.
+	 *
+	 * (?) Exhausted pool gives less blocks, than requested. Pool, which fails
+	 * to commit pages in the middle of batch, gives blocks taken so far.
+	 *
+	 * @param pBlocks - blocks array to fill.
+	 * @param pCount - requested blocks count.
+	 * @return - taken blocks count, at least 1.
+	 * @throws - can throw std::bad_alloc & std::length_error, when no block is available.
+	*/
+	size_type take( void ** pBlocks, const size_type pCount )
+	{
+
+		std::lock_guard<std::mutex> lock_( mutex_ );
+
+		// Take blocks, until pool is exhausted
+		size_type count_ = 0;
+		try
+		{
+			while ( count_ < pCount && !pool_.exhausted( ) )
+			{
+				pBlocks[count_] = pool_.allocate( );
+				count_++;
+			}
+		}
+		catch ( const std::bad_alloc& )
+		{
+			// Keep taken blocks
+			if ( count_ < 1 )
+				throw;
+		}
+
+		// Check if exceeded
+		if ( count_ < 1 )
+			throw std::length_error( "linear_depot::take - maximum objects exceeded" );
+
+		// Count refill
+		refills_++;
+
+		// Return taken blocks count
+		return( count_ );
+
+	}
+
+	/* Returns batch of blocks from magazine flush */
+	void give( void *const * pBlocks, const size_type pCount ) noexcept
+	{
+
+		std::lock_guard<std::mutex> lock_( mutex_ );
+
+		// Return blocks
+		for ( size_type i = 0; i < pCount; i++ )
+			pool_.deallocate( pBlocks[i] );
+
+		// Count flush
+		flushes_++;
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_depot const copy constructor */
+	linear_depot( const linear_depot & ) = delete;
+
+	/* @deleted linear_depot const copy assignment operator */
+	linear_depot & operator=( const linear_depot & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // MULTITHREADING
+
+#endif // !C0DE4UN_LINEAR_DEPOT_HPP
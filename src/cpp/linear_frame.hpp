@@ -0,0 +1,164 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_FRAME_HPP
+#define C0DE4UN_LINEAR_FRAME_HPP
+
+/* FRAME REQUIRED HEADERS */
+
+#include <cstddef> // size_t, max_align_t
+
+#include "linear_arena.hpp" // linear_arena
+
+/* END OF FRAME REQUIRED HEADERS */
+
+/*
+ * linear_frame - double-buffered per-tick allocator.
+ *
+ * (?) Allocations of the current tick go to one arena, while the other one keeps
+ * allocations of the previous tick readable. Next tick swaps arenas & resets
+ * the older one in O(1), there are no per-object frees.
+*/
+class linear_frame
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_frame constructor.
+	 *
+	 * @param pSize - size in bytes of each arena.
+	 * @throws - can throw std::bad_alloc
+	*/
+	explicit linear_frame( const std::size_t pSize )
+		: first_( pSize ),
+		second_( pSize ),
+		current_( &first_ ),
+		previous_( &second_ ),
+		highWater_( 0 ),
+		ticks_( 0 )
+	{
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns size in bytes of each arena */
+	std::size_t capacity( ) const noexcept
+	{ return( current_->capacity( ) ); }
+
+	/* Returns bytes count, used by the current tick */
+	std::size_t used( ) const noexcept
+	{ return( current_->used( ) ); }
+
+	/* Returns bytes count, used by the previous tick */
+	std::size_t previous_used( ) const noexcept
+	{ return( previous_->used( ) ); }
+
+	/*
+	 * Returns max. bytes count, used by a single tick.
+	 *
+	 * (?) Includes the current tick, allows to size arenas.
+	*/
+	std::size_t high_water( ) const noexcept
+	{ return( current_->used( ) > highWater_ ? current_->used( ) : highWater_ ); }
+
+	/* Returns finished ticks count */
+	std::size_t ticks( ) const noexcept
+	{ return( ticks_ ); }
+
+	/*
+	 * Allocates bytes for the current tick.
+	 *
+	 * (?) Memory stays valid during the current & the next ticks.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - size in bytes.
+	 * @param pAlign - alignment, power of 2.
+	 * @throws - can throw std::length_error, when arena is exhausted.
+	*/
+	void * allocate( const std::size_t pSize, const std::size_t pAlign = alignof( std::max_align_t ) )
+	{ return( current_->allocate( pSize, pAlign ) ); }
+
+	/*
+	 * Finishes the current tick.
+	 *
+	 * (!) Memory, allocated during the previous tick, is released.
+	*/
+	void next_tick( ) noexcept
+	{
+
+		// Update high-water mark
+		highWater_ = high_water( );
+
+		// Swap arenas
+		linear_arena *const arena_( previous_ );
+		previous_ = current_;
+		current_ = arena_;
+
+		// Release the older tick
+		current_->reset( );
+
+		// Count tick
+		ticks_++;
+
+	}
+
+	/* Resets high-water mark */
+	void reset_high_water( ) noexcept
+	{ highWater_ = 0; }
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* First arena */
+	linear_arena first_;
+
+	/* Second arena */
+	linear_arena second_;
+
+	/* Arena of the current tick */
+	linear_arena * current_;
+
+	/* Arena of the previous tick */
+	linear_arena * previous_;
+
+	/* Max. bytes count, used by finished ticks */
+	std::size_t highWater_;
+
+	/* Finished ticks count */
+	std::size_t ticks_;
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_frame const copy constructor */
+	linear_frame( const linear_frame & ) = delete;
+
+	/* @deleted linear_frame const copy assignment operator */
+	linear_frame & operator=( const linear_frame & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_FRAME_HPP
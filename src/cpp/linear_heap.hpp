@@ -0,0 +1,465 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+#ifndef C0DE4UN_LINEAR_HEAP_HPP
+#define C0DE4UN_LINEAR_HEAP_HPP
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/* HEAP REQUIRED HEADERS */
+
+#include <cstddef> // size_t
+#include <cstdint> // uintptr_t
+#include <new> // new
+
+#include "linear_atomic_pool.hpp" // linear_atomic_pool
+#include "linear_small_allocator.hpp" // linear_small_allocator size classes
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF HEAP REQUIRED HEADERS */
+
+/*
+ * linear_heap - thread-safe heap of small blocks, one lock-free pool per size class.
+ *
+ * (?) Size classes are linear_small_allocator classes, each class is linear_atomic_pool
+ * with fixed capacity. Pool buffer is reserved at construction, but its pages aren't
+ * touched until blocks are used.
+ *
+ * (?) Heap never calls upstream: request above the largest class, or class without
+ * available blocks, returns nullptr, & owner supplies memory itself. Deallocation
+ * reports, if block belongs to the heap, so foreign blocks are returned to owner.
+ *
+ * (?) Block class is found by branchless binary search of pool buffers, sorted by address.
+ * Sized deallocation checks only pool of the given size.
+ *
+ * (?) Thread can keep blocks in own cache, like linear_depot magazine: cache hit doesn't
+ * touch pool atomics. Empty cache of the class is refilled with half of its size,
+ * full cache returns upper half to the pool.
+ *
+ * @config
+ * - _C0DE4UN_MULTITHREADING_ENABLED_ - required, heap isn't defined without it.
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_heap
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Classes count */
+	static constexpr size_type CLASSES_COUNT = linear_small_allocator::CLASSES_COUNT;
+
+	/* Invalid class index, used for foreign blocks */
+	static constexpr size_type NO_CLASS = linear_small_allocator::NO_CLASS;
+
+	/* Default pool capacity of each class in bytes */
+	static constexpr size_type DEFAULT_CLASS_CAPACITY = 64 * 1024 * 1024;
+
+	/* Blocks count of the thread cache of each class */
+	static constexpr size_type CACHE_SIZE = 32;
+
+	// ===========================================================
+	// Cache
+	// ===========================================================
+
+	/*
+	 * cache - blocks of one thread, per class.
+	 *
+	 * (?) Trivial type, so it can be zero-initialized thread_local of malloc replacement
+	 * without constructor & destructor. Owner flushes cache at thread exit.
+	*/
+	class cache
+	{
+
+		// -------------------------------------------------------- \\
+
+		/* Heap accesses blocks */
+		friend class linear_heap;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Cached blocks of each class */
+		void * blocks_[CLASSES_COUNT][CACHE_SIZE];
+
+		/* Cached blocks count of each class */
+		size_type counts_[CLASSES_COUNT];
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_heap constructor.
+	 *
+	 * @param pClassCapacity - pool capacity of each class in bytes, at least one block.
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	explicit linear_heap( const size_type pClassCapacity = DEFAULT_CLASS_CAPACITY )
+		: pools_( reinterpret_cast<linear_atomic_pool*>( storage_ ) )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_heap::constructor; class_capacity=" << pClassCapacity << std::endl;
+#endif // DEBUG
+
+		// Construct pools, block alignment is the largest power of 2, which divides class size
+		size_type constructed_ = 0;
+		try
+		{
+			for ( ; constructed_ < CLASSES_COUNT; constructed_++ )
+			{
+				const size_type size_( linear_small_allocator::class_size( constructed_ ) );
+				new( pools_ + constructed_ ) linear_atomic_pool( size_, pClassCapacity > size_ ? pClassCapacity / size_ : 1, linear_allocator_mode::free_list, size_ & ( ~size_ + 1 ) );
+			}
+		}
+		catch ( ... )
+		{
+			for ( size_type i = 0; i < constructed_; i++ )
+				pools_[i].~linear_atomic_pool( );
+			throw;
+		}
+
+		// Sort pools by buffer address
+		for ( size_type i = 0; i < CLASSES_COUNT; i++ )
+		{
+			const std::uintptr_t start_( reinterpret_cast<std::uintptr_t>( pools_[i].data( ) ) );
+			size_type index_( i );
+			while ( index_ > 0 && starts_[index_ - 1] > start_ )
+			{
+				starts_[index_] = starts_[index_ - 1];
+				spans_[index_] = spans_[index_ - 1];
+				classes_[index_] = classes_[index_ - 1];
+				index_--;
+			}
+			starts_[index_] = start_;
+			spans_[index_] = pools_[i].capacity( ) * linear_small_allocator::class_size( i );
+			classes_[index_] = i;
+		}
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/*
+	 * linear_heap destructor.
+	 *
+	 * (!) All blocks must be deallocated, pools release their buffers.
+	*/
+	~linear_heap( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_heap::destructor" << std::endl;
+#endif // DEBUG
+
+		// Destroy pools
+		for ( size_type i = 0; i < CLASSES_COUNT; i++ )
+			pools_[i].~linear_atomic_pool( );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns pool of the class */
+	const linear_atomic_pool & pool( const size_type pClass ) const noexcept
+	{ return( pools_[pClass] ); }
+
+	/*
+	 * Returns class of the block, or NO_CLASS for foreign block.
+	 *
+	 * (?) O(log classes), fixed steps count & conditional moves, so random classes
+	 * don't cause branch mispredictions.
+	*/
+	size_type owner( const void *const ptr_ ) const noexcept
+	{
+
+		// Search last pool, which buffer starts before the pointer
+		const std::uintptr_t address_( reinterpret_cast<std::uintptr_t>( ptr_ ) );
+		size_type first_ = 0;
+		for ( size_type count_ = CLASSES_COUNT; count_ > 1; )
+		{
+			const size_type half_( count_ / 2 );
+			first_ = starts_[first_ + half_] <= address_ ? first_ + half_ : first_;
+			count_ -= half_;
+		}
+
+		// Return class, address below the first buffer wraps around
+		return( address_ - starts_[first_] < spans_[first_] ? classes_[first_] : NO_CLASS );
+
+	}
+
+	/*
+	 * Returns usable size in bytes of the block, or 0 for foreign block.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	size_type usable_size( const void *const ptr_ ) const noexcept
+	{
+
+		// Class
+		const size_type class_( owner( ptr_ ) );
+
+		// Return class size
+		return( class_ != NO_CLASS ? linear_small_allocator::class_size( class_ ) : 0 );
+
+	}
+
+	/*
+	 * Allocates bytes from the pool of the class.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @param pBytes - size in bytes.
+	 * @param pAlign - alignment, power of 2, or 0 for malloc alignment.
+	 * @return - block, or nullptr when request doesn't fit any class, or pool is empty.
+	*/
+	void * try_allocate( const size_type pBytes, const size_type pAlign = 0 ) noexcept
+	{
+
+		// Class
+		const size_type class_( linear_small_allocator::class_of( pBytes, pAlign ) );
+
+		// Pop block
+		return( class_ != NO_CLASS ? pools_[class_].try_allocate( ) : nullptr );
+
+	}
+
+	/*
+	 * Allocates bytes from the thread cache, refills it from the pool of the class.
+	 *
+	 * @thread_safety - thread-safe, lock-free, cache belongs to the calling thread.
+	 * @param pCache - cache of the calling thread.
+	 * @param pBytes - size in bytes.
+	 * @param pAlign - alignment, power of 2, or 0 for malloc alignment.
+	 * @return - block, or nullptr when request doesn't fit any class, or pool is empty.
+	*/
+	void * try_allocate( cache & pCache, const size_type pBytes, const size_type pAlign = 0 ) noexcept
+	{
+
+		// Class
+		const size_type class_( linear_small_allocator::class_of( pBytes, pAlign ) );
+		if ( class_ == NO_CLASS )
+			return( nullptr );
+
+		// Refill empty cache
+		size_type & count_( pCache.counts_[class_] );
+		if ( count_ < 1 )
+		{
+			for ( ; count_ < CACHE_SIZE / 2; count_++ )
+			{
+				void *const block_( pools_[class_].try_allocate( ) );
+				if ( block_ == nullptr )
+					break;
+				pCache.blocks_[class_][count_] = block_;
+			}
+		}
+
+		// Pop block
+		return( count_ > 0 ? pCache.blocks_[class_][--count_] : nullptr );
+
+	}
+
+	/*
+	 * Deallocates block of any class.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @return - 'TRUE' if block belongs to the heap & was deallocated.
+	*/
+	bool deallocate( void *const ptr_ ) noexcept
+	{
+
+		// Class
+		const size_type class_( owner( ptr_ ) );
+		if ( class_ == NO_CLASS )
+			return( false );
+
+		// Return block
+		pools_[class_].deallocate( ptr_ );
+		return( true );
+
+	}
+
+	/*
+	 * Deallocates block with known size, without search of the class.
+	 *
+	 * (?) Block is checked against the pool of the size only, block from other
+	 * pool falls back to search.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @param pBytes - size in bytes, same as allocated.
+	 * @param pAlign - alignment, same as allocated.
+	 * @return - 'TRUE' if block belongs to the heap & was deallocated.
+	*/
+	bool deallocate( void *const ptr_, const size_type pBytes, const size_type pAlign = 0 ) noexcept
+	{
+
+		// Class
+		const size_type class_( linear_small_allocator::class_of( pBytes, pAlign ) );
+
+		// Pool of the size
+		if ( class_ != NO_CLASS && pools_[class_].owns( ptr_ ) )
+		{
+			pools_[class_].deallocate( ptr_ );
+			return( true );
+		}
+
+		// Search
+		return( deallocate( ptr_ ) );
+
+	}
+
+	/*
+	 * Deallocates block of any class to the thread cache.
+	 *
+	 * @thread_safety - thread-safe, lock-free, cache belongs to the calling thread.
+	 * @return - 'TRUE' if block belongs to the heap & was deallocated.
+	*/
+	bool deallocate( cache & pCache, void *const ptr_ ) noexcept
+	{
+
+		// Class
+		const size_type class_( owner( ptr_ ) );
+		if ( class_ == NO_CLASS )
+			return( false );
+
+		// Cache block
+		push( pCache, class_, ptr_ );
+		return( true );
+
+	}
+
+	/*
+	 * Deallocates block with known size to the thread cache, without search of the class.
+	 *
+	 * @thread_safety - thread-safe, lock-free, cache belongs to the calling thread.
+	 * @param pBytes - size in bytes, same as allocated.
+	 * @param pAlign - alignment, same as allocated.
+	 * @return - 'TRUE' if block belongs to the heap & was deallocated.
+	*/
+	bool deallocate( cache & pCache, void *const ptr_, const size_type pBytes, const size_type pAlign = 0 ) noexcept
+	{
+
+		// Class
+		const size_type class_( linear_small_allocator::class_of( pBytes, pAlign ) );
+
+		// Pool of the size
+		if ( class_ != NO_CLASS && pools_[class_].owns( ptr_ ) )
+		{
+			push( pCache, class_, ptr_ );
+			return( true );
+		}
+
+		// Search
+		return( deallocate( pCache, ptr_ ) );
+
+	}
+
+	/*
+	 * Returns all blocks of the thread cache to pools.
+	 *
+	 * @thread_safety - thread-safe, lock-free, cache belongs to the calling thread.
+	*/
+	void flush( cache & pCache ) noexcept
+	{
+		for ( size_type i = 0; i < CLASSES_COUNT; i++ )
+		{
+			for ( ; pCache.counts_[i] > 0; pCache.counts_[i]-- )
+				pools_[i].deallocate( pCache.blocks_[i][pCache.counts_[i] - 1] );
+		}
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Pools storage, heap doesn't allocate outside of pools */
+	alignas( linear_atomic_pool ) unsigned char storage_[CLASSES_COUNT * sizeof( linear_atomic_pool )];
+
+	/* Pools, indexed by class */
+	linear_atomic_pool *const pools_;
+
+	/* Buffer addresses of pools, sorted */
+	std::uintptr_t starts_[CLASSES_COUNT];
+
+	/* Buffer sizes in bytes, in address order */
+	size_type spans_[CLASSES_COUNT];
+
+	/* Classes, in address order */
+	size_type classes_[CLASSES_COUNT];
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Caches block, full cache returns upper half to the pool */
+	void push( cache & pCache, const size_type pClass, void *const ptr_ ) noexcept
+	{
+
+		// Return upper half
+		size_type & count_( pCache.counts_[pClass] );
+		if ( count_ == CACHE_SIZE )
+		{
+			for ( ; count_ > CACHE_SIZE / 2; count_-- )
+				pools_[pClass].deallocate( pCache.blocks_[pClass][count_ - 1] );
+		}
+
+		// Push block
+		pCache.blocks_[pClass][count_++] = ptr_;
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_heap const copy constructor */
+	linear_heap( const linear_heap & ) = delete;
+
+	/* @deleted linear_heap const copy assignment operator */
+	linear_heap & operator=( const linear_heap & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // MULTITHREADING
+
+#endif // !C0DE4UN_LINEAR_HEAP_HPP
@@ -0,0 +1,367 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+/*
+ * linear_malloc - malloc/free replacement for unmodified binaries, loaded with LD_PRELOAD.
+ *
+ * (?) Requests up to linear_small_allocator::MAX_SIZE are served by linear_heap,
+ * larger requests & requests of exhausted classes go to glibc through __libc_* entry
+ * points, so shim doesn't call itself. free sends blocks, which heap doesn't own,
+ * back to glibc, so memalign, valloc & other allocations of glibc are released correctly.
+ *
+ * (?) Each thread allocates & deallocates through own linear_heap cache, thread exit
+ * returns cached blocks to pools through destructor of pthread key.
+ *
+ * (?) Heap is constructed by the first call. Nested calls during construction, & calls
+ * of other threads at that time, are served by glibc. Heap is never destroyed,
+ * blocks can be released by exit handlers of the process.
+ *
+ * (?) Pool capacity of each class can be set in MiB by LINEAR_MALLOC_CLASS_MB
+ * environment variable.
+ *
+ * (!) Linux & glibc only. Log-output is disabled, cout allocates.
+ *
+ * Usage: LD_PRELOAD=liblinear_malloc.so program
+*/
+
+// Log-output allocates
+#undef __linear_allocator_debug_enabled_
+
+/* MALLOC SHIM REQUIRED HEADERS */
+
+#include <cstdlib> // malloc, free, calloc, realloc, aligned_alloc, getenv, atol
+#include <cstddef> // size_t
+#include <cstring> // memcpy, memset
+#include <cerrno> // errno, ENOMEM, EINVAL
+#include <atomic> // atomic
+#include <new> // new
+
+#include <malloc.h> // malloc_usable_size, memalign
+#include <dlfcn.h> // dlsym, RTLD_NEXT
+#include <pthread.h> // pthread_key_create, pthread_setspecific
+
+#include "linear_heap.hpp" // linear_heap
+
+/* END OF MALLOC SHIM REQUIRED HEADERS */
+
+// ===========================================================
+// glibc
+// ===========================================================
+
+/* glibc allocator entry points, not replaced by the shim */
+extern "C"
+{
+	void * __libc_malloc( std::size_t ) noexcept;
+	void __libc_free( void * ) noexcept;
+	void * __libc_calloc( std::size_t, std::size_t ) noexcept;
+	void * __libc_realloc( void *, std::size_t ) noexcept;
+	void * __libc_memalign( std::size_t, std::size_t ) noexcept;
+}
+
+// ===========================================================
+// Heap
+// ===========================================================
+
+/* Heap states */
+static constexpr int STATE_NONE = 0;
+static constexpr int STATE_INITIALIZING = 1;
+static constexpr int STATE_READY = 2;
+static constexpr int STATE_DISABLED = 3;
+
+/* Heap state */
+static std::atomic<int> state_( STATE_NONE );
+
+/* Heap storage, heap isn't allocated from itself */
+alignas( linear_heap ) static unsigned char heap_storage_[sizeof( linear_heap )];
+
+/* Thread cache, zero-initialized static TLS of preloaded library */
+static thread_local linear_heap::cache cache_ __attribute__( ( tls_model( "initial-exec" ) ) );
+
+/* 'TRUE' if thread cache flush is registered */
+static thread_local bool cacheRegistered_ __attribute__( ( tls_model( "initial-exec" ) ) );
+
+/* Key, which destructor flushes thread cache at thread exit */
+static pthread_key_t cacheKey_;
+
+/* Returns pool capacity of each class */
+static std::size_t class_capacity( ) noexcept
+{
+
+	// Environment
+	const char *const value_( std::getenv( "LINEAR_MALLOC_CLASS_MB" ) );
+	const long mb_( value_ != nullptr ? std::atol( value_ ) : 0 );
+
+	// Return capacity
+	return( mb_ > 0 ? static_cast<std::size_t>( mb_ ) * 1024 * 1024 : linear_heap::DEFAULT_CLASS_CAPACITY );
+
+}
+
+/*
+ * Returns thread cache to pools, runs at thread exit.
+ *
+ * (?) Allocation by later destructors registers flush again, pthread repeats destructors.
+*/
+static void flush_cache( void *const pCache ) noexcept
+{
+	cacheRegistered_ = false;
+	reinterpret_cast<linear_heap*>( heap_storage_ )->flush( *static_cast<linear_heap::cache*>( pCache ) );
+}
+
+/*
+ * Returns heap, or nullptr while heap isn't ready.
+ *
+ * (?) First caller constructs heap. Heap is disabled, if construction fails.
+*/
+static linear_heap * heap( ) noexcept
+{
+
+	// Ready
+	int state_value_( state_.load( std::memory_order_acquire ) );
+	if ( state_value_ == STATE_READY )
+		return( reinterpret_cast<linear_heap*>( heap_storage_ ) );
+
+	// Construct
+	if ( state_value_ == STATE_NONE && state_.compare_exchange_strong( state_value_, STATE_INITIALIZING, std::memory_order_acquire ) )
+	{
+		try
+		{
+			if ( pthread_key_create( &cacheKey_, flush_cache ) != 0 )
+				throw std::bad_alloc( );
+			new( heap_storage_ ) linear_heap( class_capacity( ) );
+			state_.store( STATE_READY, std::memory_order_release );
+			return( reinterpret_cast<linear_heap*>( heap_storage_ ) );
+		}
+		catch ( ... )
+		{
+			state_.store( STATE_DISABLED, std::memory_order_release );
+		}
+	}
+
+	// Initializing or disabled
+	return( nullptr );
+
+}
+
+/* Returns cache of the calling thread, registers its flush */
+static linear_heap::cache & thread_cache( ) noexcept
+{
+
+	// Register flush
+	if ( !cacheRegistered_ )
+	{
+		cacheRegistered_ = true;
+		pthread_setspecific( cacheKey_, &cache_ );
+	}
+
+	// Return cache
+	return( cache_ );
+
+}
+
+/* Returns 'TRUE' if the alignment is power of 2 */
+static bool is_power_of_2( const std::size_t pAlign ) noexcept
+{ return( pAlign > 0 && ( pAlign & ( pAlign - 1 ) ) == 0 ); }
+
+/* Returns usable size of glibc block */
+static std::size_t libc_usable_size( void *const ptr_ ) noexcept
+{
+
+	// glibc malloc_usable_size, next after the shim
+	using usable_size_function = std::size_t ( * )( void * );
+	static const usable_size_function function_( reinterpret_cast<usable_size_function>( dlsym( RTLD_NEXT, "malloc_usable_size" ) ) );
+
+	// Return size
+	return( function_ != nullptr ? function_( ptr_ ) : 0 );
+
+}
+
+/* Allocates aligned bytes, returns nullptr on failure */
+static void * allocate_aligned( const std::size_t pAlign, const std::size_t pBytes ) noexcept
+{
+
+	// Heap block
+	linear_heap *const heap_( heap( ) );
+	void *const ptr_( heap_ != nullptr ? heap_->try_allocate( thread_cache( ), pBytes, pAlign ) : nullptr );
+
+	// Return block, or glibc block
+	return( ptr_ != nullptr ? ptr_ : __libc_memalign( pAlign, pBytes ) );
+
+}
+
+// ===========================================================
+// malloc API
+// ===========================================================
+
+// Library is built with hidden visibility, only malloc API is exported
+#pragma GCC visibility push( default )
+
+extern "C"
+{
+
+	void * malloc( std::size_t pBytes ) noexcept
+	{
+
+		// Heap block
+		linear_heap *const heap_( heap( ) );
+		void *const ptr_( heap_ != nullptr ? heap_->try_allocate( thread_cache( ), pBytes ) : nullptr );
+
+		// Return block, or glibc block
+		return( ptr_ != nullptr ? ptr_ : __libc_malloc( pBytes ) );
+
+	}
+
+	void free( void * ptr_ ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Heap block, or glibc block
+		linear_heap *const heap_( heap( ) );
+		if ( heap_ == nullptr || !heap_->deallocate( thread_cache( ), ptr_ ) )
+			__libc_free( ptr_ );
+
+	}
+
+	void * calloc( std::size_t pCount, std::size_t pSize ) noexcept
+	{
+
+		// Check overflow
+		if ( pSize != 0 && pCount > static_cast<std::size_t>( -1 ) / pSize )
+		{
+			errno = ENOMEM;
+			return( nullptr );
+		}
+
+		// Heap block, reused blocks aren't zeroed
+		linear_heap *const heap_( heap( ) );
+		void *const ptr_( heap_ != nullptr ? heap_->try_allocate( thread_cache( ), pCount * pSize ) : nullptr );
+		if ( ptr_ != nullptr )
+			return( std::memset( ptr_, 0, pCount * pSize ) );
+
+		// glibc block
+		return( __libc_calloc( pCount, pSize ) );
+
+	}
+
+	void * realloc( void * ptr_, std::size_t pBytes ) noexcept
+	{
+
+		// Allocate
+		if ( ptr_ == nullptr )
+			return( malloc( pBytes ) );
+
+		// Deallocate
+		if ( pBytes == 0 )
+		{
+			free( ptr_ );
+			return( nullptr );
+		}
+
+		// glibc block
+		linear_heap *const heap_( heap( ) );
+		const std::size_t class_( heap_ != nullptr ? heap_->owner( ptr_ ) : linear_heap::NO_CLASS );
+		if ( class_ == linear_heap::NO_CLASS )
+			return( __libc_realloc( ptr_, pBytes ) );
+
+		// Same class, block stays
+		if ( linear_small_allocator::class_of( pBytes ) == class_ )
+			return( ptr_ );
+
+		// Move to the new block
+		void *const block_( malloc( pBytes ) );
+		if ( block_ == nullptr )
+			return( nullptr );
+		const std::size_t size_( linear_small_allocator::class_size( class_ ) );
+		std::memcpy( block_, ptr_, size_ < pBytes ? size_ : pBytes );
+		heap_->deallocate( thread_cache( ), ptr_ );
+
+		// Return new block
+		return( block_ );
+
+	}
+
+	void * reallocarray( void * ptr_, std::size_t pCount, std::size_t pSize ) noexcept
+	{
+
+		// Check overflow
+		if ( pSize != 0 && pCount > static_cast<std::size_t>( -1 ) / pSize )
+		{
+			errno = ENOMEM;
+			return( nullptr );
+		}
+
+		// Reallocate
+		return( realloc( ptr_, pCount * pSize ) );
+
+	}
+
+	int posix_memalign( void ** pResult, std::size_t pAlign, std::size_t pBytes ) noexcept
+	{
+
+		// Check alignment
+		if ( !is_power_of_2( pAlign ) || pAlign % sizeof( void* ) != 0 )
+			return( EINVAL );
+
+		// Allocate
+		void *const ptr_( allocate_aligned( pAlign, pBytes ) );
+		if ( ptr_ == nullptr )
+			return( ENOMEM );
+
+		// Return block
+		*pResult = ptr_;
+		return( 0 );
+
+	}
+
+	void * aligned_alloc( std::size_t pAlign, std::size_t pBytes ) noexcept
+	{
+
+		// Check alignment
+		if ( !is_power_of_2( pAlign ) )
+		{
+			errno = EINVAL;
+			return( nullptr );
+		}
+
+		// Allocate
+		return( allocate_aligned( pAlign, pBytes ) );
+
+	}
+
+	void * memalign( std::size_t pAlign, std::size_t pBytes ) noexcept
+	{
+
+		// glibc rounds up alignment, which isn't power of 2
+		if ( !is_power_of_2( pAlign ) )
+			return( __libc_memalign( pAlign, pBytes ) );
+
+		// Allocate
+		return( allocate_aligned( pAlign, pBytes ) );
+
+	}
+
+	std::size_t malloc_usable_size( void * ptr_ ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return( 0 );
+
+		// Heap block
+		linear_heap *const heap_( heap( ) );
+		const std::size_t size_( heap_ != nullptr ? heap_->usable_size( ptr_ ) : 0 );
+
+		// Return size, or glibc size
+		return( size_ > 0 ? size_ : libc_usable_size( ptr_ ) );
+
+	}
+
+}
+
+#pragma GCC visibility pop
@@ -0,0 +1,208 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_MEMORY_HPP
+#define C0DE4UN_LINEAR_MEMORY_HPP
+
+/* MEMORY REQUIRED HEADERS */
+
+#include <cstddef> // size_t
+#include <cstdio> // fopen, fscanf, fgets, sscanf, fclose
+#include <cstdint> // uintptr_t
+
+#if defined( __linux__ ) // LINUX
+
+#include <unistd.h> // sysconf
+#include <sys/mman.h> // madvise
+#include <sys/resource.h> // getrusage
+
+#endif // LINUX
+
+/* END OF MEMORY REQUIRED HEADERS */
+
+/*
+ * Memory page & process memory statistics.
+ *
+ * (?) On other platforms, than Linux, page is 4 KiB & statistics are 0.
+*/
+
+/* Huge page size in bytes, PMD size of x86-64 & arm64 with 4 KiB pages */
+constexpr std::size_t LINEAR_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/* Returns page size in bytes */
+inline std::size_t linear_page_size( ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	static const std::size_t size_( static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) ) );
+	return( size_ );
+#else // OTHER
+	return( 4096 );
+#endif // LINUX
+
+}
+
+/*
+ * Returns resident set size (RSS) of the process in bytes.
+ *
+ * (?) Read from /proc/self/statm, 0 when it isn't available.
+*/
+inline std::size_t linear_resident_size( ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	// Open statistics
+	std::FILE *const file_( std::fopen( "/proc/self/statm", "r" ) );
+	if ( file_ == nullptr )
+		return( 0 );
+
+	// Total & resident pages
+	unsigned long total_( 0 );
+	unsigned long resident_( 0 );
+	const int read_( std::fscanf( file_, "%lu %lu", &total_, &resident_ ) );
+	std::fclose( file_ );
+
+	// Return bytes
+	return( read_ == 2 ? static_cast<std::size_t>( resident_ ) * linear_page_size( ) : 0 );
+#else // OTHER
+	return( 0 );
+#endif // LINUX
+
+}
+
+/*
+ * Returns minor page faults of the calling thread (of the process, when per-thread count isn't available).
+ *
+ * (?) Difference of two calls around steady-state allocations must be 0, when backing
+ * store was prefaulted.
+*/
+inline std::size_t linear_minor_faults( ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	// Usage of the thread
+	struct rusage usage_;
+#ifdef RUSAGE_THREAD
+	const int who_( RUSAGE_THREAD );
+#else // PROCESS
+	const int who_( RUSAGE_SELF );
+#endif // RUSAGE_THREAD
+
+	// Return faults
+	return( getrusage( who_, &usage_ ) == 0 ? static_cast<std::size_t>( usage_.ru_minflt ) : 0 );
+#else // OTHER
+	return( 0 );
+#endif // LINUX
+
+}
+
+/*
+ * Populates pages of the given range for write, so first touch doesn't fault.
+ *
+ * (?) MADV_POPULATE_WRITE (Linux 5.14) populates pages in kernel. Otherwise each page is
+ * touched with atomic OR of 0, which faults page in for write & keeps contents,
+ * so range can be used by other thread meanwhile.
+ *
+ * @param pAddress - first byte.
+ * @param pSize - size in bytes.
+ * @return - populated bytes.
+*/
+inline std::size_t linear_populate( void *const pAddress, const std::size_t pSize ) noexcept
+{
+
+	// Nothing to populate
+	if ( pAddress == nullptr || pSize == 0 )
+		return( 0 );
+
+	// Range
+	const std::uintptr_t page_( linear_page_size( ) );
+	const std::uintptr_t address_( reinterpret_cast<std::uintptr_t>( pAddress ) );
+
+#if defined( __linux__ ) && defined( MADV_POPULATE_WRITE ) // LINUX 5.14
+	// Pages of the range
+	const std::uintptr_t first_( address_ & ~( page_ - 1 ) );
+	const std::uintptr_t last_( ( address_ + pSize + page_ - 1 ) & ~( page_ - 1 ) );
+
+	// Populate in kernel
+	if ( madvise( reinterpret_cast<void*>( first_ ), last_ - first_, MADV_POPULATE_WRITE ) == 0 )
+		return( pSize );
+#endif // LINUX 5.14
+
+	// Touch one byte of each page inside the range
+	for ( std::uintptr_t byte_ = address_; byte_ < address_ + pSize; byte_ = ( byte_ & ~( page_ - 1 ) ) + page_ )
+	{
+#if defined( __GNUC__ ) // GCC & CLANG
+		__atomic_fetch_or( reinterpret_cast<unsigned char*>( byte_ ), static_cast<unsigned char>( 0 ), __ATOMIC_RELAXED );
+#else // OTHER
+		volatile unsigned char *const touch_( reinterpret_cast<volatile unsigned char*>( byte_ ) );
+		*touch_ = *touch_;
+#endif // GNUC
+	}
+
+	// Return populated bytes
+	return( pSize );
+
+}
+
+/*
+ * Returns resident bytes in huge pages of mappings, which overlap the given range.
+ *
+ * (?) Sums AnonHugePages (transparent huge pages) & Private_Hugetlb (MAP_HUGETLB)
+ * of /proc/self/smaps, so it shows, whether huge pages were actually obtained.
+ * Whole mapping is counted, when range covers its part.
+ *
+ * @param pAddress - first byte of the range.
+ * @param pSize - range size in bytes.
+*/
+inline std::size_t linear_huge_resident_size( const void *const pAddress, const std::size_t pSize ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	// Open mappings
+	std::FILE *const file_( std::fopen( "/proc/self/smaps", "r" ) );
+	if ( file_ == nullptr )
+		return( 0 );
+
+	// Range
+	const std::uintptr_t first_( reinterpret_cast<std::uintptr_t>( pAddress ) );
+	const std::uintptr_t last_( first_ + pSize );
+
+	// Read mappings
+	char line_[256];
+	bool inside_( false );
+	std::size_t bytes_( 0 );
+	while ( std::fgets( line_, sizeof( line_ ), file_ ) != nullptr )
+	{
+
+		// Mapping header
+		unsigned long start_( 0 );
+		unsigned long end_( 0 );
+		if ( std::sscanf( line_, "%lx-%lx ", &start_, &end_ ) == 2 )
+		{
+			inside_ = start_ < last_ && end_ > first_;
+			continue;
+		}
+
+		// Huge pages of the mapping
+		unsigned long kb_( 0 );
+		if ( inside_ && ( std::sscanf( line_, "AnonHugePages: %lu kB", &kb_ ) == 1 || std::sscanf( line_, "Private_Hugetlb: %lu kB", &kb_ ) == 1 ) )
+			bytes_ += static_cast<std::size_t>( kb_ ) * 1024;
+
+	}
+	std::fclose( file_ );
+
+	// Return bytes
+	return( bytes_ );
+#else // OTHER
+	( void ) pAddress;
+	( void ) pSize;
+	return( 0 );
+#endif // LINUX
+
+}
+
+#endif // !C0DE4UN_LINEAR_MEMORY_HPP
@@ -0,0 +1,353 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+/*
+ * linear_new - replacement of global operator new & operator delete, opt-in.
+ *
+ * (?) Add this translation unit to program sources, & every new & delete expression,
+ * including array, nothrow, aligned & sized forms, uses linear_heap.
+ * Requests above linear_small_allocator::MAX_SIZE, & requests of exhausted classes,
+ * go to malloc.
+ *
+ * (?) Sized delete maps size straight to the size class, & checks only pool of that
+ * class, without search of the block. Unsized delete searches pool by address.
+ *
+ * (?) Each thread allocates & deallocates through own linear_heap cache, returned
+ * to pools at thread exit. Heap is constructed by the first call & never destroyed,
+ * so objects, destroyed after main, are deallocated correctly.
+ *
+ * @config
+ * - _C0DE4UN_MULTITHREADING_ENABLED_ - required, linear_heap isn't defined without it.
+ * - __linear_allocator_debug_enabled_ - disabled in this unit, cout allocates.
+*/
+
+// Log-output allocates
+#undef __linear_allocator_debug_enabled_
+
+/* NEW REQUIRED HEADERS */
+
+#include <cstdlib> // malloc, free, aligned_alloc
+#include <cstddef> // size_t
+#include <new> // new, delete, std::bad_alloc, std::align_val_t, std::nothrow_t, std::get_new_handler
+#include <atomic> // atomic
+
+#ifdef _WIN32 // WINDOWS
+
+#include <malloc.h> // _aligned_malloc & _aligned_free
+
+#endif // WINDOWS
+
+#include "linear_heap.hpp" // linear_heap
+
+/* END OF NEW REQUIRED HEADERS */
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+// ===========================================================
+// Heap
+// ===========================================================
+
+/* Heap states */
+static constexpr int STATE_NONE = 0;
+static constexpr int STATE_INITIALIZING = 1;
+static constexpr int STATE_READY = 2;
+static constexpr int STATE_DISABLED = 3;
+
+/* Heap state */
+static std::atomic<int> state_( STATE_NONE );
+
+/* Heap storage, heap is never destroyed */
+alignas( linear_heap ) static unsigned char heap_storage_[sizeof( linear_heap )];
+
+/*
+ * Returns heap, or nullptr while heap isn't ready.
+ *
+ * (?) First caller constructs heap, other threads use malloc meanwhile.
+ * Heap is disabled, if construction fails.
+*/
+static linear_heap * heap( ) noexcept
+{
+
+	// Ready
+	int state_value_( state_.load( std::memory_order_acquire ) );
+	if ( state_value_ == STATE_READY )
+		return( reinterpret_cast<linear_heap*>( heap_storage_ ) );
+
+	// Construct
+	if ( state_value_ == STATE_NONE && state_.compare_exchange_strong( state_value_, STATE_INITIALIZING, std::memory_order_acquire ) )
+	{
+		try
+		{
+			new( heap_storage_ ) linear_heap( );
+			state_.store( STATE_READY, std::memory_order_release );
+			return( reinterpret_cast<linear_heap*>( heap_storage_ ) );
+		}
+		catch ( ... )
+		{
+			state_.store( STATE_DISABLED, std::memory_order_release );
+		}
+	}
+
+	// Initializing or disabled
+	return( nullptr );
+
+}
+
+/*
+ * Thread cache owner, returns cached blocks to pools at thread exit.
+ *
+ * (?) Thread-local destructors, which run later, find cache closed, & use pools directly.
+*/
+struct linear_new_cache
+{
+
+	/* Cache */
+	linear_heap::cache cache_;
+
+	/* 'TRUE' after thread-local destruction */
+	bool closed_;
+
+	/* Flushes cache */
+	~linear_new_cache( )
+	{
+		closed_ = true;
+		linear_heap *const heap_( heap( ) );
+		if ( heap_ != nullptr )
+			heap_->flush( cache_ );
+	}
+
+};
+
+/* Thread cache */
+static thread_local linear_new_cache cache_ = { };
+
+/* Allocates block from heap, nullptr when heap doesn't serve the request */
+static void * heap_allocate( const std::size_t pBytes, const std::size_t pAlign ) noexcept
+{
+
+	// Heap
+	linear_heap *const heap_( heap( ) );
+	if ( heap_ == nullptr )
+		return( nullptr );
+
+	// Cache, or pool after thread exit
+	return( cache_.closed_ ? heap_->try_allocate( pBytes, pAlign ) : heap_->try_allocate( cache_.cache_, pBytes, pAlign ) );
+
+}
+
+/* Deallocates block of any class, 'TRUE' if heap owns it */
+static bool heap_deallocate( void *const ptr_ ) noexcept
+{
+
+	// Heap
+	linear_heap *const heap_( heap( ) );
+	if ( heap_ == nullptr )
+		return( false );
+
+	// Cache, or pool after thread exit
+	return( cache_.closed_ ? heap_->deallocate( ptr_ ) : heap_->deallocate( cache_.cache_, ptr_ ) );
+
+}
+
+/* Deallocates block of the size class, 'TRUE' if heap owns it */
+static bool heap_deallocate( void *const ptr_, const std::size_t pBytes, const std::size_t pAlign ) noexcept
+{
+
+	// Heap
+	linear_heap *const heap_( heap( ) );
+	if ( heap_ == nullptr )
+		return( false );
+
+	// Cache, or pool after thread exit
+	return( cache_.closed_ ? heap_->deallocate( ptr_, pBytes, pAlign ) : heap_->deallocate( cache_.cache_, ptr_, pBytes, pAlign ) );
+
+}
+
+// ===========================================================
+// Upstream
+// ===========================================================
+
+/* Allocates block with malloc, nullptr on failure */
+static void * upstream_allocate( const std::size_t pBytes, const std::size_t pAlign ) noexcept
+{
+
+	// Default alignment
+	if ( pAlign == 0 )
+		return( std::malloc( pBytes > 0 ? pBytes : 1 ) );
+
+	// Size is multiple of the alignment
+	const std::size_t size_( ( ( pBytes > 0 ? pBytes : 1 ) + pAlign - 1 ) / pAlign * pAlign );
+
+#ifdef _WIN32 // WINDOWS
+	return( _aligned_malloc( size_, pAlign ) );
+#else // POSIX
+	return( std::aligned_alloc( pAlign, size_ ) );
+#endif // WINDOWS
+
+}
+
+/* Releases block of malloc */
+static void upstream_deallocate( void *const ptr_, const std::size_t pAlign ) noexcept
+{
+
+#ifdef _WIN32 // WINDOWS
+	if ( pAlign > 0 )
+	{
+		_aligned_free( ptr_ );
+		return;
+	}
+#endif // WINDOWS
+
+	// Release
+	( void ) pAlign;
+	std::free( ptr_ );
+
+}
+
+// ===========================================================
+// Allocation
+// ===========================================================
+
+/*
+ * Allocates block, calls new-handler until allocation succeeds.
+ *
+ * @param pAlign - alignment, or 0 for default new alignment.
+ * @throws - can throw std::bad_alloc
+*/
+static void * allocate( const std::size_t pBytes, const std::size_t pAlign )
+{
+
+	for ( ;; )
+	{
+
+		// Heap block, or malloc block
+		void * ptr_( heap_allocate( pBytes, pAlign ) );
+		if ( ptr_ == nullptr )
+			ptr_ = upstream_allocate( pBytes, pAlign );
+		if ( ptr_ != nullptr )
+			return( ptr_ );
+
+		// New-handler
+		const std::new_handler handler_( std::get_new_handler( ) );
+		if ( handler_ == nullptr )
+			throw std::bad_alloc( );
+		handler_( );
+
+	}
+
+}
+
+/* Allocates block, returns nullptr on failure */
+static void * allocate_nothrow( const std::size_t pBytes, const std::size_t pAlign ) noexcept
+{
+	try
+	{
+		return( allocate( pBytes, pAlign ) );
+	}
+	catch ( ... )
+	{
+		return( nullptr );
+	}
+}
+
+/* Deallocates block, searches its class */
+static void deallocate( void *const ptr_, const std::size_t pAlign ) noexcept
+{
+
+	// Nothing was allocated
+	if ( ptr_ == nullptr )
+		return;
+
+	// Heap block, or malloc block
+	if ( !heap_deallocate( ptr_ ) )
+		upstream_deallocate( ptr_, pAlign );
+
+}
+
+/* Deallocates block of the given size, without search of its class */
+static void deallocate_sized( void *const ptr_, const std::size_t pBytes, const std::size_t pAlign ) noexcept
+{
+
+	// Nothing was allocated
+	if ( ptr_ == nullptr )
+		return;
+
+	// Heap block, or malloc block
+	if ( !heap_deallocate( ptr_, pBytes, pAlign ) )
+		upstream_deallocate( ptr_, pAlign );
+
+}
+
+// ===========================================================
+// operator new
+// ===========================================================
+
+void * operator new( std::size_t pBytes )
+{ return( allocate( pBytes, 0 ) ); }
+
+void * operator new[]( std::size_t pBytes )
+{ return( allocate( pBytes, 0 ) ); }
+
+void * operator new( std::size_t pBytes, const std::nothrow_t & ) noexcept
+{ return( allocate_nothrow( pBytes, 0 ) ); }
+
+void * operator new[]( std::size_t pBytes, const std::nothrow_t & ) noexcept
+{ return( allocate_nothrow( pBytes, 0 ) ); }
+
+void * operator new( std::size_t pBytes, std::align_val_t pAlign )
+{ return( allocate( pBytes, static_cast<std::size_t>( pAlign ) ) ); }
+
+void * operator new[]( std::size_t pBytes, std::align_val_t pAlign )
+{ return( allocate( pBytes, static_cast<std::size_t>( pAlign ) ) ); }
+
+void * operator new( std::size_t pBytes, std::align_val_t pAlign, const std::nothrow_t & ) noexcept
+{ return( allocate_nothrow( pBytes, static_cast<std::size_t>( pAlign ) ) ); }
+
+void * operator new[]( std::size_t pBytes, std::align_val_t pAlign, const std::nothrow_t & ) noexcept
+{ return( allocate_nothrow( pBytes, static_cast<std::size_t>( pAlign ) ) ); }
+
+// ===========================================================
+// operator delete
+// ===========================================================
+
+void operator delete( void * ptr_ ) noexcept
+{ deallocate( ptr_, 0 ); }
+
+void operator delete[]( void * ptr_ ) noexcept
+{ deallocate( ptr_, 0 ); }
+
+void operator delete( void * ptr_, const std::nothrow_t & ) noexcept
+{ deallocate( ptr_, 0 ); }
+
+void operator delete[]( void * ptr_, const std::nothrow_t & ) noexcept
+{ deallocate( ptr_, 0 ); }
+
+void operator delete( void * ptr_, std::size_t pBytes ) noexcept
+{ deallocate_sized( ptr_, pBytes, 0 ); }
+
+void operator delete[]( void * ptr_, std::size_t pBytes ) noexcept
+{ deallocate_sized( ptr_, pBytes, 0 ); }
+
+void operator delete( void * ptr_, std::align_val_t pAlign ) noexcept
+{ deallocate( ptr_, static_cast<std::size_t>( pAlign ) ); }
+
+void operator delete[]( void * ptr_, std::align_val_t pAlign ) noexcept
+{ deallocate( ptr_, static_cast<std::size_t>( pAlign ) ); }
+
+void operator delete( void * ptr_, std::align_val_t pAlign, const std::nothrow_t & ) noexcept
+{ deallocate( ptr_, static_cast<std::size_t>( pAlign ) ); }
+
+void operator delete[]( void * ptr_, std::align_val_t pAlign, const std::nothrow_t & ) noexcept
+{ deallocate( ptr_, static_cast<std::size_t>( pAlign ) ); }
+
+void operator delete( void * ptr_, std::size_t pBytes, std::align_val_t pAlign ) noexcept
+{ deallocate_sized( ptr_, pBytes, static_cast<std::size_t>( pAlign ) ); }
+
+void operator delete[]( void * ptr_, std::size_t pBytes, std::align_val_t pAlign ) noexcept
+{ deallocate_sized( ptr_, pBytes, static_cast<std::size_t>( pAlign ) ); }
+
+#endif // MULTITHREADING
@@ -0,0 +1,171 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_NUMA_HPP
+#define C0DE4UN_LINEAR_NUMA_HPP
+
+/* NUMA REQUIRED HEADERS */
+
+#include <cstddef> // size_t
+#include <cstdio> // snprintf
+
+#if defined( __linux__ ) // LINUX
+
+#include <unistd.h> // syscall
+#include <sys/syscall.h> // SYS_mbind, SYS_get_mempolicy, SYS_getcpu
+#include <dirent.h> // opendir, readdir, closedir
+#include <cstdlib> // atoi
+#include <cstring> // strncmp
+
+#endif // LINUX
+
+/* END OF NUMA REQUIRED HEADERS */
+
+/*
+ * NUMA memory placement through raw system calls, without libnuma.
+ *
+ * (?) On other platforms, than Linux, functions report single node 0 & binding fails.
+*/
+
+/* No node, memory placement isn't changed */
+constexpr int LINEAR_NUMA_NO_NODE = -1;
+
+/* Nodes limit of the node mask */
+constexpr std::size_t LINEAR_NUMA_NODES_LIMIT = 1024;
+
+/* Memory policy modes & flags of linux/mempolicy.h */
+constexpr int LINEAR_NUMA_MPOL_DEFAULT = 0;
+constexpr int LINEAR_NUMA_MPOL_BIND = 2;
+constexpr unsigned long LINEAR_NUMA_MPOL_F_NODE = 1;
+constexpr unsigned long LINEAR_NUMA_MPOL_F_ADDR = 2;
+
+/*
+ * Binds pages of the given range to the node with mbind.
+ *
+ * (!) Range must start at page boundary, & pages must not be touched yet,
+ * policy applies to pages, allocated after the call.
+ *
+ * @param pAddress - first byte, page aligned.
+ * @param pSize - size in bytes.
+ * @param pNode - node number.
+ * @return - 'TRUE' if policy was set.
+*/
+inline bool linear_numa_bind( void *const pAddress, const std::size_t pSize, const int pNode ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	// Check node
+	if ( pNode < 0 || static_cast<std::size_t>( pNode ) >= LINEAR_NUMA_NODES_LIMIT )
+		return( false );
+
+	// Node mask
+	constexpr std::size_t WORD_BITS = sizeof( unsigned long ) * 8;
+	unsigned long mask_[LINEAR_NUMA_NODES_LIMIT / WORD_BITS] = { };
+	mask_[pNode / WORD_BITS] = 1UL << ( pNode % WORD_BITS );
+
+	// Bind
+	return( syscall( SYS_mbind, pAddress, pSize, LINEAR_NUMA_MPOL_BIND, mask_, LINEAR_NUMA_NODES_LIMIT + 1, 0 ) == 0 );
+#else // OTHER
+	return( false );
+#endif // LINUX
+
+}
+
+/*
+ * Returns policy mode of the page with get_mempolicy, LINEAR_NUMA_MPOL_BIND for bound range.
+ *
+ * @return - mode, or LINEAR_NUMA_NO_NODE on failure.
+*/
+inline int linear_numa_policy_of( const void *const pAddress ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	int mode_( LINEAR_NUMA_NO_NODE );
+	return( syscall( SYS_get_mempolicy, &mode_, nullptr, 0, pAddress, LINEAR_NUMA_MPOL_F_ADDR ) == 0 ? mode_ : LINEAR_NUMA_NO_NODE );
+#else // OTHER
+	return( pAddress != nullptr ? LINEAR_NUMA_MPOL_DEFAULT : LINEAR_NUMA_NO_NODE );
+#endif // LINUX
+
+}
+
+/*
+ * Returns node of the page with get_mempolicy.
+ *
+ * (!) Page is allocated, if it wasn't touched yet.
+ *
+ * @return - node, or LINEAR_NUMA_NO_NODE on failure.
+*/
+inline int linear_numa_node_of( const void *const pAddress ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	int node_( LINEAR_NUMA_NO_NODE );
+	return( syscall( SYS_get_mempolicy, &node_, nullptr, 0, pAddress, LINEAR_NUMA_MPOL_F_NODE | LINEAR_NUMA_MPOL_F_ADDR ) == 0 ? node_ : LINEAR_NUMA_NO_NODE );
+#else // OTHER
+	return( pAddress != nullptr ? 0 : LINEAR_NUMA_NO_NODE );
+#endif // LINUX
+
+}
+
+/*
+ * Returns node of the calling thread CPU with getcpu.
+ *
+ * (!) Thread can migrate right after the call, so result is a hint.
+*/
+inline int linear_numa_current_node( ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	unsigned int cpu_( 0 );
+	unsigned int node_( 0 );
+	return( syscall( SYS_getcpu, &cpu_, &node_, nullptr ) == 0 ? static_cast<int>( node_ ) : 0 );
+#else // OTHER
+	return( 0 );
+#endif // LINUX
+
+}
+
+/*
+ * Returns node of the given CPU.
+ *
+ * (?) Linux lists node of the CPU as 'nodeN' entry of /sys/devices/system/cpu/cpuM.
+ * Node 0 is returned, when entry isn't found.
+*/
+inline int linear_numa_node_of_cpu( const unsigned int pCpu ) noexcept
+{
+
+#if defined( __linux__ ) // LINUX
+	// CPU directory
+	char path_[64];
+	std::snprintf( path_, sizeof( path_ ), "/sys/devices/system/cpu/cpu%u", pCpu );
+	DIR *const dir_( opendir( path_ ) );
+	if ( dir_ == nullptr )
+		return( 0 );
+
+	// Search node entry
+	int node_( 0 );
+	for ( const dirent * entry_ = readdir( dir_ ); entry_ != nullptr; entry_ = readdir( dir_ ) )
+	{
+		if ( std::strncmp( entry_->d_name, "node", 4 ) == 0 && entry_->d_name[4] >= '0' && entry_->d_name[4] <= '9' )
+		{
+			node_ = std::atoi( entry_->d_name + 4 );
+			break;
+		}
+	}
+
+	// Close directory
+	closedir( dir_ );
+
+	// Return node
+	return( node_ );
+#else // OTHER
+	return( 0 );
+#endif // LINUX
+
+}
+
+#endif // !C0DE4UN_LINEAR_NUMA_HPP
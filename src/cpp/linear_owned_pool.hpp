@@ -0,0 +1,367 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_OWNED_POOL_HPP
+#define C0DE4UN_LINEAR_OWNED_POOL_HPP
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/* OWNED POOL REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free
+#include <cstddef> // size_t, max_align_t
+#include <cstdint> // uint32_t
+#include <new> // std::bad_alloc
+#include <stdexcept> // std::length_error, std::invalid_argument
+#include <atomic> // atomic
+#include <thread> // this_thread::get_id, thread::id
+
+#include "linear_buffer.hpp" // linear_buffer
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF OWNED POOL REQUIRED HEADERS */
+
+/*
+ * linear_owned_pool - pool of fixed size blocks, owned by one thread, with remote frees.
+ *
+ * (?) Owner thread allocates & deallocates with plain free-list, without atomics.
+ * Other threads push deallocated blocks into remote-free queue - lock-free
+ * multi-producer, single-consumer stack of block indices. Owner drains whole queue
+ * with one exchange, when own free-list is empty, & continues with its blocks.
+ * So cross-thread frees don't touch cache lines of the owner free-list.
+ *
+ * (?) Consumer takes all blocks at once & never pops single block, so queue has no ABA.
+ *
+ * (?) Links of both lists are stored in separate array of block indices, block is
+ * linked by thread, which owns it, & list head publishes the link.
+ *
+ * @config
+ * - _C0DE4UN_MULTITHREADING_ENABLED_ - required, pool isn't defined without it.
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_owned_pool
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Cache line size in bytes, remote-free queue head is isolated to own cache line */
+	static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+	/* Invalid block index, used as end of lists. Also limits blocks count. */
+	static constexpr std::uint32_t NO_INDEX = static_cast<std::uint32_t>( -1 );
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_owned_pool constructor.
+	 *
+	 * (?) Constructing thread becomes owner, see bind.
+	 *
+	 * @param pObjectSize - object size in bytes.
+	 * @param pCount - blocks count, less than NO_INDEX.
+	 * @param pAlignment - blocks alignment, power of 2.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
+	*/
+	linear_owned_pool( const std::size_t pObjectSize, const std::size_t pCount, const std::size_t pAlignment = alignof( std::max_align_t ) )
+		: count_( check_count( pCount ) ),
+		elementSize_( block_size( pObjectSize, pAlignment ) ),
+		buffer_( count_ * elementSize_, pAlignment ),
+		links_( static_cast<std::uint32_t*>( std::malloc( count_ * sizeof( std::uint32_t ) ) ) ),
+		owner_( std::this_thread::get_id( ) ),
+		freeHead_( NO_INDEX ),
+		untouchedIndex_( 0 ),
+		drains_( 0 ),
+		remoteHead_( NO_INDEX )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_owned_pool::constructor; elements: " << count_ << "; element_size=" << elementSize_ << std::endl;
+#endif // DEBUG
+
+		// Check allocation
+		if ( links_ == nullptr )
+			throw std::bad_alloc( );
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_owned_pool destructor */
+	~linear_owned_pool( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_owned_pool::destructor" << std::endl;
+#endif // DEBUG
+
+		// Release links
+		std::free( links_ );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns blocks count */
+	size_type capacity( ) const noexcept
+	{ return( count_ ); }
+
+	/* Returns number of remote-free queue drains */
+	size_type drains( ) const noexcept
+	{ return( drains_ ); }
+
+	/* Returns 'TRUE' if the given pointer is inside pool buffer */
+	bool owns( const void *const ptr_ ) const noexcept
+	{ return( static_cast<const unsigned char*>( ptr_ ) >= buffer_.data( ) && static_cast<const unsigned char*>( ptr_ ) < buffer_.data( ) + count_ * elementSize_ ); }
+
+	/* Returns 'TRUE' if the calling thread is owner */
+	bool is_owner( ) const noexcept
+	{ return( std::this_thread::get_id( ) == owner_ ); }
+
+	/*
+	 * Makes the calling thread owner.
+	 *
+	 * @thread_safety - not thread-safe, previous owner must stop using the pool.
+	*/
+	void bind( ) noexcept
+	{ owner_ = std::this_thread::get_id( ); }
+
+	/*
+	 * Allocates 1 block.
+	 *
+	 * @thread_safety - owner thread only.
+	 * @throws - can throw std::length_error, when all blocks are reserved.
+	*/
+	void * allocate( )
+	{
+
+		// Pop block
+		void *const ptr_( try_allocate( ) );
+
+		// Check if exceeded
+		if ( ptr_ == nullptr )
+			throw std::length_error( "linear_owned_pool::allocate - maximum objects exceeded" );
+
+		// Return pointer
+		return( ptr_ );
+
+	}
+
+	/*
+	 * Allocates 1 block, returns nullptr when all blocks are reserved.
+	 *
+	 * (?) Order: own free-list, remote-free queue, never reserved blocks.
+	 *
+	 * @thread_safety - owner thread only.
+	*/
+	void * try_allocate( ) noexcept
+	{
+
+		// Own free-list is empty, take all remote frees at once
+		if ( freeHead_ == NO_INDEX && remoteHead_.load( std::memory_order_relaxed ) != NO_INDEX )
+		{
+			freeHead_ = remoteHead_.exchange( NO_INDEX, std::memory_order_acquire );
+			drains_++;
+		}
+
+		// Block index
+		std::uint32_t index_( freeHead_ );
+		if ( index_ != NO_INDEX )
+			freeHead_ = links_[index_];
+		else if ( untouchedIndex_ < count_ )
+			index_ = static_cast<std::uint32_t>( untouchedIndex_++ );
+		else
+			return( nullptr );
+
+		// Return block
+		return( buffer_.data( ) + static_cast<size_type>( index_ ) * elementSize_ );
+
+	}
+
+	/*
+	 * Deallocates 1 block, from any thread.
+	 *
+	 * (?) Owner links block to own free-list, other threads push it to remote-free queue.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param ptr_ - block of this pool.
+	*/
+	void deallocate( void *const ptr_ ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Owner or remote thread
+		if ( is_owner( ) )
+			deallocate_local( ptr_ );
+		else
+			deallocate_remote( ptr_ );
+
+	}
+
+	/*
+	 * Deallocates 1 block to own free-list.
+	 *
+	 * @thread_safety - owner thread only.
+	*/
+	void deallocate_local( void *const ptr_ ) noexcept
+	{
+
+		// Block index
+		const std::uint32_t index_( index_of( ptr_ ) );
+
+		// Link block before head & make it head
+		links_[index_] = freeHead_;
+		freeHead_ = index_;
+
+	}
+
+	/*
+	 * Deallocates 1 block to remote-free queue.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	*/
+	void deallocate_remote( void *const ptr_ ) noexcept
+	{
+
+		// Block index
+		const std::uint32_t index_( index_of( ptr_ ) );
+
+		// Link block before head & make it head, release publishes the link
+		std::uint32_t head_( remoteHead_.load( std::memory_order_relaxed ) );
+		do
+		{
+			links_[index_] = head_;
+		}
+		while ( !remoteHead_.compare_exchange_weak( head_, index_, std::memory_order_release, std::memory_order_relaxed ) );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Blocks count */
+	const std::size_t count_;
+
+	/* Size (length) in bytes of the element (item, block) */
+	const std::size_t elementSize_;
+
+	/* Buffer */
+	linear_buffer buffer_;
+
+	/* Next block index of each block, in own free-list or remote-free queue */
+	std::uint32_t * links_;
+
+	/* Owner thread */
+	std::thread::id owner_;
+
+	/* Own free-list head */
+	std::uint32_t freeHead_;
+
+	/* Index of the first block, which never was reserved */
+	std::size_t untouchedIndex_;
+
+	/* Number of remote-free queue drains */
+	std::size_t drains_;
+
+	/*
+	 * Remote-free queue head.
+	 *
+	 * (?) Head is the last field & aligned to cache line, so remote threads
+	 * don't share cache line with owner fields.
+	*/
+	alignas( CACHE_LINE_SIZE ) std::atomic<std::uint32_t> remoteHead_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns block index for the given pointer */
+	std::uint32_t index_of( const void *const ptr_ ) const noexcept
+	{ return( static_cast<std::uint32_t>( static_cast<size_type>( static_cast<const unsigned char*>( ptr_ ) - buffer_.data( ) ) / elementSize_ ) ); }
+
+	/* Returns blocks count, if it can be addressed by 32-bit index */
+	static std::size_t check_count( const std::size_t pCount )
+	{
+
+		// Check if exceeded
+		if ( pCount >= NO_INDEX )
+			throw std::length_error( "linear_owned_pool::constructor - objects count is too big" );
+
+		// Return blocks count
+		return( pCount > 0 ? pCount : 1 );
+
+	}
+
+	/*
+	 * Returns block size in bytes, rounded up to the alignment.
+	 *
+	 * @throws - can throw std::invalid_argument
+	*/
+	static std::size_t block_size( const std::size_t pObjectSize, const std::size_t pAlignment )
+	{
+
+		// Check alignment
+		if ( pAlignment < 1 || ( pAlignment & ( pAlignment - 1 ) ) != 0 )
+			throw std::invalid_argument( "linear_owned_pool::constructor - alignment must be power of 2" );
+
+		// Round up to the alignment
+		return( ( ( pObjectSize > 0 ? pObjectSize : 1 ) + pAlignment - 1 ) / pAlignment * pAlignment );
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_owned_pool const copy constructor */
+	linear_owned_pool( const linear_owned_pool & ) = delete;
+
+	/* @deleted linear_owned_pool const copy assignment operator */
+	linear_owned_pool & operator=( const linear_owned_pool & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // MULTITHREADING
+
+#endif // !C0DE4UN_LINEAR_OWNED_POOL_HPP
@@ -0,0 +1,1044 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_POOL_HPP
+#define C0DE4UN_LINEAR_POOL_HPP
+
+/* POOL REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free
+#include <cstddef> // size_t, max_align_t
+#include <new> // new, std::bad_alloc
+#include <stdexcept> // std::length_error, std::invalid_argument
+#include <cstring> // memcpy
+
+#include "linear_bitmap.hpp" // linear_bitmap
+#include "linear_buffer.hpp" // linear_buffer
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+#include <thread> // thread
+#include <vector> // vector
+#include <utility> // pair, move
+
+#endif // MULTITHREADING
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+#include <string> // to_string
+
+#endif // DEBUG
+
+/* END OF POOL REQUIRED HEADERS */
+
+/*
+ * linear_allocator blocks search mode.
+ *
+ * - bitmap - available block is searched in the blocks status bitmap.
+ * - free_list - available blocks are linked into intrusive list, stored inside
+ * unused blocks. Allocation & deallocation are O(1), whatever pool fill is.
+*/
+enum class linear_allocator_mode : unsigned char
+{
+	bitmap,
+	free_list
+};
+
+/*
+ * linear_allocator growth policy, used when all blocks are reserved.
+ *
+ * - none - std::length_error is thrown.
+ * - fixed - another slab with the same blocks count is added.
+ * - geometric - another slab with twice more blocks, than the last one, is added.
+*/
+enum class linear_allocator_growth : unsigned char
+{
+	none,
+	fixed,
+	geometric
+};
+
+/*
+ * linear_pool - untyped pool of fixed size blocks.
+ *
+ * (?) Blocks are stored in slabs. Without growth there is only one slab,
+ * other slabs are added by growth policy & never move, so pointers stay valid.
+ *
+ * (?) Block size is rounded up to the alignment, & slab buffer starts at the alignment,
+ * so over-aligned types (SIMD vectors, padded counters) get aligned blocks.
+ *
+ * (?) Pool doesn't construct or destroy objects, linear_allocator does.
+ *
+ * (?) With lazy commit, slab buffer reserves address space only, & pages are committed,
+ * when blocks above the high-water mark are reserved. release_free_pages returns pages
+ * of available blocks to OS.
+ *
+ * (?) prefault, or populate commit policy, faults slab & blocks status pages in, so first
+ * allocations don't page-fault. Slabs, added by growth, are prefaulted by populate policy only.
+ *
+ * (?) With huge pages, each slab buffer starts at huge page boundary. Huge pages may be
+ * unavailable, huge_slabs_count & huge_bytes report, what was actually obtained.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_pool
+{
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Config
+	// ===========================================================
+
+	/* Invalid block index, used as end of free-list & empty cache */
+	static constexpr std::size_t NO_BLOCK = static_cast<std::size_t>( -1 );
+
+	// -------------------------------------------------------- \\
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_pool constructor.
+	 *
+	 * (?) In free_list mode block is at least size_type long, to store link to the next available block.
+	 *
+	 * @param pObjectSize - object size in bytes.
+	 * @param pCount - objects (items, elements) limit of the first slab. Blocks status bitmap is sized for it.
+	 * @param pMode - blocks search mode.
+	 * @param pGrowth - growth policy, when all blocks are reserved.
+	 * @param pAlignment - blocks alignment, power of 2.
+	 * @param pCommit - slab memory commit policy.
+	 * @param pPages - slab pages policy.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
+	*/
+	linear_pool( const std::size_t pObjectSize, const std::size_t pCount, const linear_allocator_mode pMode = linear_allocator_mode::bitmap, const linear_allocator_growth pGrowth = linear_allocator_growth::none, const std::size_t pAlignment = alignof( std::max_align_t ), const linear_allocator_commit pCommit = linear_allocator_commit::eager, const linear_allocator_pages pPages = linear_allocator_pages::normal )
+		: mode_( pMode ),
+		growth_( pGrowth ),
+		commit_( pCommit ),
+		pages_( pPages ),
+		alignment_( pAlignment > 0 ? pAlignment : 1 ),
+		objectSize_( pObjectSize > 0 ? pObjectSize : 1 ),
+		elementSize_( block_size( objectSize_, pMode, alignment_ ) ),
+		count_( 0 ),
+		available_count_( 0 ),
+		nextCount_( pCount > 0 ? pCount : 1 ),
+		slabs_( nullptr ),
+		slabsCount_( 0 ),
+		current_( nullptr )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::constructor; elements: " << pCount << "; element_size=" << elementSize_ << "total_size=" << pCount * elementSize_ << std::endl;
+#endif // DEBUG
+
+		// Check alignment
+		if ( ( alignment_ & ( alignment_ - 1 ) ) != 0 )
+			throw std::invalid_argument( "linear_pool::constructor - alignment must be power of 2" );
+
+		// Allocate first slab
+		try
+		{
+			current_ = add_slab( pCount );
+		}
+		catch ( ... )
+		{
+			std::free( slabs_ );
+			throw;
+		}
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_pool destructor */
+	~linear_pool( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::destructor" << std::endl;
+#endif // DEBUG
+
+		// Release slabs
+		for ( size_type i = 0; i < slabsCount_; i++ )
+		{
+			slabs_[i]->~slab( );
+			std::free( slabs_[i] );
+		}
+
+		// Release slabs array
+		std::free( slabs_ );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns blocks search mode */
+	linear_allocator_mode mode( ) const noexcept
+	{ return( mode_ ); }
+
+	/* Returns object size in bytes */
+	size_type object_size( ) const noexcept
+	{ return( objectSize_ ); }
+
+	/* Returns blocks alignment */
+	size_type alignment( ) const noexcept
+	{ return( alignment_ ); }
+
+	/* Returns max objects count of one allocation */
+	size_type max_size( ) const noexcept
+	{ return( static_cast<std::size_t>( -1 ) / objectSize_ ); }
+
+	/* Returns available blocks count */
+	size_type available_size( ) const noexcept
+	{ return( available_count_ ); }
+
+	/* Returns reserved blocks count */
+	size_type reserved_size( ) const noexcept
+	{ return( count_ - available_count_ ); }
+
+	/* Returns slabs count */
+	size_type slabs_count( ) const noexcept
+	{ return( slabsCount_ ); }
+
+	/* Returns slab memory commit policy */
+	linear_allocator_commit commit( ) const noexcept
+	{ return( commit_ ); }
+
+	/* Returns requested slab pages policy */
+	linear_allocator_pages pages( ) const noexcept
+	{ return( pages_ ); }
+
+	/* Returns count of slabs, which buffer got huge pages policy */
+	size_type huge_slabs_count( ) const noexcept
+	{
+		size_type count_( 0 );
+		for ( size_type i = 0; i < slabsCount_; i++ )
+			count_ += slabs_[i]->buffer_.pages( ) != linear_allocator_pages::normal ? 1 : 0;
+		return( count_ );
+	}
+
+	/*
+	 * Returns resident bytes of all slab buffers, backed by huge pages.
+	 *
+	 * (?) Reads /proc/self/smaps, not for hot path.
+	*/
+	size_type huge_bytes( ) const noexcept
+	{
+		size_type bytes_( 0 );
+		for ( size_type i = 0; i < slabsCount_; i++ )
+			bytes_ += slabs_[i]->buffer_.huge_resident( );
+		return( bytes_ );
+	}
+
+	/* Returns accessible bytes of all slab buffers */
+	size_type committed_bytes( ) const noexcept
+	{
+		size_type bytes_( 0 );
+		for ( size_type i = 0; i < slabsCount_; i++ )
+			bytes_ += slabs_[i]->buffer_.committed( );
+		return( bytes_ );
+	}
+
+	/* Returns 'TRUE' if all blocks are reserved & pool can't grow */
+	bool exhausted( ) const noexcept
+	{ return( available_count_ < 1 && growth_ == linear_allocator_growth::none ); }
+
+	/*
+	 * Returns 'TRUE' if the given pointer is inside one of slabs.
+	 *
+	 * (?) O(log slabs), same search as deallocate.
+	*/
+	bool owns( const void *const ptr_ ) const noexcept
+	{
+
+		// Owning slab candidate
+		const slab *const slab_( find_slab( ptr_ ) );
+
+		// Check buffer range
+		const unsigned char *const address_( static_cast<const unsigned char*>( ptr_ ) );
+		return( address_ >= slab_->buffer_.data( ) && address_ < slab_->buffer_.data( ) + slab_->count_ * elementSize_ );
+
+	}
+
+	/*
+	 * Allocates given amount of objects (elements)
+	 * & returns pointer to first element.
+	 *
+	 * (?) Several objects are placed into the first run of contiguous available blocks (bitmap mode only).
+	 *
+	 * (?) When all blocks are reserved, another slab is added by growth policy.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pCount - number of elements (size, count).
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	void * allocate( const size_type pCount = 1 )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::allocate - allocating " << pCount << " objects, already allocated:" << reserved_size( ) << " objects." << std::endl;
+#endif // DEBUG
+
+		// Check if exceeded
+		if ( available_count_ < 1 && growth_ == linear_allocator_growth::none )
+			throw std::length_error( "linear_pool::allocate - maximum objects exceeded" );
+
+		// Check allocation-size
+		if ( pCount < 1 )
+			return( nullptr );
+
+		// Run of blocks
+		if ( pCount > 1 )
+			return( allocate_run( pCount ) );
+
+		// Slab with available block
+		if ( current_->available_count_ < 1 )
+			current_ = available_slab( );
+
+		// Get available block index
+		const size_type index_( mode_ == linear_allocator_mode::free_list ? current_->pop_free_block( ) : current_->search_free_block( ) );
+
+		// Pointer (address, offset) to the block
+		void *const ptr_( current_->buffer_.data( ) + ( index_ * elementSize_ ) );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::allocate - reserving block #" << std::to_string( index_ ) << " ; address=" << ptr_ << std::endl;
+#endif // DEBUG
+
+		// Reserve. Status is kept in free_list mode too, to answer occupancy queries.
+		current_->blocks_status_.set( index_ );
+
+		// Decrease available blocks counters
+		current_->available_count_--;
+		available_count_--;
+
+		// Return pointer to the offset-address
+		return( ptr_ );
+
+	}
+
+	/*
+	 * Deallocate.
+	 *
+	 * (!) Objects aren't destroyed, owner destroys constructed elements itself.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param ptr_ - pointer/offset to the block of memory.
+	 * @param size_ - number of objects (blocks) to deallocate from
+	 * the given offset (pointer, address).
+	*/
+	void deallocate( void *const ptr_, const size_type size_ = 1 ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Run of blocks
+		if ( size_ > 1 )
+		{
+			deallocate_run( ptr_, size_ );
+			return;
+		}
+
+		// Owning slab
+		slab *const slab_( find_slab( ptr_ ) );
+
+		// Get block index from the offset, all blocks of the slab are stored in one buffer
+		const size_type index_ = slab_->index_of( ptr_ );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::deallocate - freeing block #" << std::to_string( index_ ) << std::endl;
+#endif // DEBUG
+
+		// Mark block as available
+		slab_->blocks_status_.reset( index_ );
+
+		// Link block to the free-list or remember it for the next search
+		if ( mode_ == linear_allocator_mode::free_list )
+			slab_->push_free_block( index_ );
+		else
+			slab_->freedIndex_ = index_;
+
+		// Increase available blocks counters
+		slab_->available_count_++;
+		available_count_++;
+
+		// Allocate from this slab, when current one is full
+		if ( current_->available_count_ < 1 )
+			current_ = slab_;
+
+	}
+
+	/*
+	 * Commits slab buffers & faults their pages & blocks status in.
+	 *
+	 * (?) Called on demand, at startup or after release_free_pages, so allocations
+	 * of steady state don't page-fault. linear_minor_faults confirms it.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @return - populated bytes.
+	*/
+	size_type prefault( ) noexcept
+	{
+		size_type bytes_( 0 );
+		for ( size_type i = 0; i < slabsCount_; i++ )
+			bytes_ += slabs_[i]->buffer_.prefault( ) + slabs_[i]->blocks_status_.prefault( );
+		return( bytes_ );
+	}
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+	/*
+	 * Commits slab buffers & faults their pages in on a background thread.
+	 *
+	 * (?) Commit & blocks status are done by the caller, thread only touches pages
+	 * with atomic OR of 0 or MADV_POPULATE_WRITE, so pool can be used meanwhile.
+	 *
+	 * (!) Returned thread must be joined before pool destruction, slabs added later aren't prefaulted.
+	 *
+	 * @thread_safety - not thread-safe, thread doesn't access pool.
+	 * @throws - can throw std::bad_alloc & std::system_error
+	*/
+	std::thread prefault_async( )
+	{
+
+		// Commit & collect ranges
+		std::vector<std::pair<unsigned char*, size_type>> ranges_;
+		ranges_.reserve( slabsCount_ );
+		for ( size_type i = 0; i < slabsCount_; i++ )
+		{
+			slabs_[i]->blocks_status_.prefault( );
+			if ( slabs_[i]->buffer_.commit( slabs_[i]->buffer_.size( ) ) )
+				ranges_.emplace_back( slabs_[i]->buffer_.data( ), slabs_[i]->buffer_.size( ) );
+		}
+
+		// Populate
+		return( std::thread( []( const std::vector<std::pair<unsigned char*, size_type>> pRanges )
+		{
+			for ( const std::pair<unsigned char*, size_type> & range_ : pRanges )
+				linear_populate( range_.first, range_.second );
+		}, std::move( ranges_ ) ) );
+
+	}
+#endif // MULTITHREADING
+
+	/*
+	 * Returns pages of available blocks to OS.
+	 *
+	 * (?) In bitmap mode every page, covered by available blocks only, is released.
+	 * In free_list mode available blocks store links, so only pages above the last
+	 * reserved block are released: they become never reserved, & free-list is rebuilt
+	 * from the remaining available blocks in address order.
+	 *
+	 * (!) Only mapped buffers (lazy commit or NUMA node) release pages. Long-lived pools
+	 * call it after peak usage is over, contents of available blocks are lost.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @return - released bytes.
+	*/
+	size_type release_free_pages( ) noexcept
+	{
+
+		// Release pages of each slab
+		size_type bytes_( 0 );
+		for ( size_type i = 0; i < slabsCount_; i++ )
+			bytes_ += mode_ == linear_allocator_mode::free_list ? slabs_[i]->release_free_tail( ) : slabs_[i]->release_free_runs( );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::release_free_pages - released " << std::to_string( bytes_ ) << " bytes" << std::endl;
+#endif // DEBUG
+
+		// Return released bytes
+		return( bytes_ );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	 * slab - buffer of blocks with own status.
+	*/
+	struct slab
+	{
+
+		/* Elements (items, blocks) count */
+		const std::size_t count_;
+
+		/* Size (length) in bytes of the element (item, object) */
+		const std::size_t elementSize_;
+
+		/* Number of available blocks (items, objects). */
+		std::size_t available_count_;
+
+		/* Buffer */
+		linear_buffer buffer_;
+
+		/*
+		 * Cache to store blocks status.
+		*/
+		linear_bitmap<> blocks_status_;
+
+		/*
+		 * Last freed block index.
+		*/
+		size_type freedIndex_;
+
+		/*
+		 * First available block in the free-list (free_list mode).
+		 *
+		 * (?) Link to the next available block is stored in the first bytes of the block.
+		*/
+		size_type freeHead_;
+
+		/*
+		 * Index of the first block, which never was reserved (free_list mode).
+		 *
+		 * (?) Blocks are linked on deallocation only, so construction doesn't touch the buffer.
+		*/
+		size_type untouchedIndex_;
+
+		/*
+		 * slab constructor.
+		 *
+		 * @param pCount - blocks count.
+		 * @param pElementSize - block size in bytes.
+		 * @param pAlignment - buffer alignment.
+		 * @param pCommit - buffer commit policy.
+		 * @param pPages - buffer pages policy.
+		 * @throws - can throw std::bad_alloc
+		*/
+		slab( const std::size_t pCount, const std::size_t pElementSize, const std::size_t pAlignment, const linear_allocator_commit pCommit, const linear_allocator_pages pPages )
+			: count_( pCount ),
+			elementSize_( pElementSize ),
+			available_count_( pCount ),
+			buffer_( pCount * pElementSize, pAlignment, LINEAR_NUMA_NO_NODE, pCommit, pPages ),
+			blocks_status_( pCount ),
+			freedIndex_( NO_BLOCK ),
+			freeHead_( NO_BLOCK ),
+			untouchedIndex_( 0 )
+		{
+		}
+
+		/*
+		 * Returns block index for the given pointer (address, offset).
+		 *
+		 * (?) All blocks are stored in one buffer, so index is calculated
+		 * from the offset instead of search, without allocations.
+		*/
+		size_type index_of( const void *const ptr_ ) const noexcept
+		{ return( static_cast<size_type>( static_cast<const unsigned char*>( ptr_ ) - buffer_.data( ) ) / elementSize_ ); }
+
+		/*
+		 * Searches available block in the blocks status bitmap (bitmap mode).
+		 *
+		 * @throws - can throw std::bad_alloc
+		*/
+		size_type search_free_block( )
+		{
+
+			// Check if last freed block still available
+			if ( freedIndex_ != NO_BLOCK )
+			{
+
+				// Last freed block index
+				const size_type index_( freedIndex_ );
+
+				// Reset last freed block
+				freedIndex_ = NO_BLOCK;
+
+				// Available
+				if ( !blocks_status_.test( index_ ) )
+					return( index_ );
+
+			}
+
+			// Search available block, 64 blocks at once
+			const size_type index_( blocks_status_.find_first_zero( ) );
+
+			// Throw bad_alloc
+			if ( index_ == linear_bitmap<>::NO_BIT || !buffer_.commit( ( index_ + 1 ) * elementSize_ ) )
+				throw std::bad_alloc( );
+
+			// Return block index
+			return( index_ );
+
+		}
+
+		/*
+		 * Takes available block from the free-list head (free_list mode).
+		 *
+		 * (!) Caller checks, that available blocks count isn't 0.
+		 *
+		 * @throws - can throw std::bad_alloc, when never reserved block can't be committed.
+		*/
+		size_type pop_free_block( )
+		{
+
+			// Free-list is empty, take never reserved block
+			if ( freeHead_ == NO_BLOCK )
+			{
+				if ( !buffer_.commit( ( untouchedIndex_ + 1 ) * elementSize_ ) )
+					throw std::bad_alloc( );
+				return( untouchedIndex_++ );
+			}
+
+			// Block index
+			const size_type index_( freeHead_ );
+
+			// Next available block is stored inside the block
+			std::memcpy( &freeHead_, buffer_.data( ) + ( index_ * elementSize_ ), sizeof( size_type ) );
+
+			// Return block index
+			return( index_ );
+
+		}
+
+		/* Links block to the free-list head (free_list mode) */
+		void push_free_block( const size_type index_ ) noexcept
+		{
+
+			// Store current head inside the block
+			std::memcpy( buffer_.data( ) + ( index_ * elementSize_ ), &freeHead_, sizeof( size_type ) );
+
+			// Block becomes head
+			freeHead_ = index_;
+
+		}
+
+		/*
+		 * Releases pages of available blocks runs (bitmap mode).
+		 *
+		 * (?) Runs bounds are searched a word at a time, full & empty words are skipped.
+		 *
+		 * @return - released bytes.
+		*/
+		std::size_t release_free_runs( ) noexcept
+		{
+
+			// Blocks, which were committed
+			const size_type committed_( ( buffer_.committed( ) + elementSize_ - 1 ) / elementSize_ );
+			const size_type limit_( committed_ < count_ ? committed_ : count_ );
+
+			// Release pages inside each run of available blocks
+			std::size_t bytes_( 0 );
+			size_type index_( blocks_status_.find_next_zero( 0 ) );
+			while ( index_ < limit_ )
+			{
+
+				// End of the run
+				const size_type next_( blocks_status_.find_next_one( index_ ) );
+				const size_type end_( next_ < limit_ ? next_ : limit_ );
+
+				// Release
+				bytes_ += buffer_.release( index_ * elementSize_, ( end_ - index_ ) * elementSize_ );
+
+				// Start of the next run
+				index_ = end_ < limit_ ? blocks_status_.find_next_zero( end_ ) : limit_;
+
+			}
+
+			// Return released bytes
+			return( bytes_ );
+
+		}
+
+		/*
+		 * Releases pages above the last reserved block (free_list mode).
+		 *
+		 * @return - released bytes.
+		*/
+		std::size_t release_free_tail( ) noexcept
+		{
+
+			// First block of the available tail
+			size_type tail_( untouchedIndex_ );
+			while ( tail_ > 0 && !blocks_status_.test( tail_ - 1 ) )
+				tail_--;
+
+			// Nothing to release
+			if ( tail_ == untouchedIndex_ )
+				return( 0 );
+
+			// Tail becomes never reserved
+			const size_type end_( untouchedIndex_ );
+			untouchedIndex_ = tail_;
+
+			// Rebuild free-list, lower addresses first
+			freeHead_ = NO_BLOCK;
+			for ( size_type i = tail_; i > 0; i-- )
+			{
+				if ( !blocks_status_.test( i - 1 ) )
+					push_free_block( i - 1 );
+			}
+
+			// Release
+			return( buffer_.release( tail_ * elementSize_, ( end_ - tail_ ) * elementSize_ ) );
+
+		}
+
+	};
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Blocks search mode */
+	const linear_allocator_mode mode_;
+
+	/* Growth policy */
+	const linear_allocator_growth growth_;
+
+	/* Slab memory commit policy */
+	const linear_allocator_commit commit_;
+
+	/* Slab pages policy */
+	const linear_allocator_pages pages_;
+
+	/* Blocks alignment */
+	const std::size_t alignment_;
+
+	/* Size (length) in bytes of the object */
+	const std::size_t objectSize_;
+
+	/* Size (length) in bytes of the element (item, block) */
+	const std::size_t elementSize_;
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Elements (items, blocks) count in all slabs */
+	std::size_t count_;
+
+	/* Number of available blocks (items, objects) in all slabs. */
+	std::size_t available_count_;
+
+	/* Blocks count of the next slab */
+	std::size_t nextCount_;
+
+	/*
+	 * Slabs, sorted by buffer address.
+	 *
+	 * (?) Allows to find owning slab of a pointer with binary search.
+	*/
+	slab ** slabs_;
+
+	/* Slabs count */
+	std::size_t slabsCount_;
+
+	/* Slab, used for single object allocations */
+	slab * current_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns block size in bytes.
+	 *
+	 * (?) In free_list mode block stores link to the next available block.
+	 * Size is rounded up to the alignment, so every block is aligned.
+	*/
+	static std::size_t block_size( const std::size_t pObjectSize, const linear_allocator_mode pMode, const std::size_t pAlignment ) noexcept
+	{
+
+		// Object or link size
+		const std::size_t size_( pMode == linear_allocator_mode::free_list && pObjectSize < sizeof( size_type ) ? sizeof( size_type ) : pObjectSize );
+
+		// Round up to the alignment
+		return( ( size_ + pAlignment - 1 ) / pAlignment * pAlignment );
+
+	}
+
+	/* Returns blocks count, required for the given objects count */
+	size_type blocks_for( const size_type pCount ) const noexcept
+	{ return( ( pCount * objectSize_ + elementSize_ - 1 ) / elementSize_ ); }
+
+	/*
+	 * Returns slab, which owns the given pointer.
+	 *
+	 * (?) O(log slabs), single slab is returned at once.
+	*/
+	slab * find_slab( const void *const ptr_ ) const noexcept
+	{
+
+		// Search last slab, which buffer starts before the pointer
+		size_type first_ = 0;
+		size_type last_ = slabsCount_;
+		while ( last_ - first_ > 1 )
+		{
+
+			// Middle slab
+			const size_type middle_( first_ + ( last_ - first_ ) / 2 );
+
+			// Go right or left
+			if ( static_cast<const unsigned char*>( ptr_ ) >= slabs_[middle_]->buffer_.data( ) )
+				first_ = middle_;
+			else
+				last_ = middle_;
+
+		}
+
+		// Return slab
+		return( slabs_[first_] );
+
+	}
+
+	/*
+	 * Returns slab with available block, adds slab if required.
+	 *
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	slab * available_slab( )
+	{
+
+		// Search slab with available block
+		if ( available_count_ > 0 )
+		{
+			for ( size_type i = 0; i < slabsCount_; i++ )
+			{
+				if ( slabs_[i]->available_count_ > 0 )
+					return( slabs_[i] );
+			}
+		}
+
+		// Grow
+		return( add_slab( nextCount_ ) );
+
+	}
+
+	/*
+	 * Allocates slab & inserts it into slabs array, sorted by buffer address.
+	 *
+	 * @param pCount - blocks count.
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	slab * add_slab( const size_type pCount )
+	{
+
+		// Check if growth allowed
+		if ( slabsCount_ > 0 && growth_ == linear_allocator_growth::none )
+			throw std::length_error( "linear_pool::allocate - maximum objects exceeded" );
+
+		// Check buffer size overflow
+		if ( pCount > static_cast<std::size_t>( -1 ) / elementSize_ )
+			throw std::length_error( "linear_pool::add_slab - objects count is too big" );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::add_slab - slab #" << std::to_string( slabsCount_ ) << "; elements: " << pCount << std::endl;
+#endif // DEBUG
+
+		// Grow slabs array
+		slab ** slabs_array_( static_cast<slab**>( std::realloc( slabs_, ( slabsCount_ + 1 ) * sizeof( slab* ) ) ) );
+		if ( slabs_array_ == nullptr )
+			throw std::bad_alloc( );
+		slabs_ = slabs_array_;
+
+		// Allocate slab
+		void *const memory_( std::malloc( sizeof( slab ) ) );
+		if ( memory_ == nullptr )
+			throw std::bad_alloc( );
+
+		// Construct slab
+		slab * slab_( nullptr );
+		try
+		{
+			slab_ = new( memory_ ) slab( pCount, elementSize_, alignment_, commit_, pages_ );
+		}
+		catch ( ... )
+		{
+			std::free( memory_ );
+			throw;
+		}
+
+		// Insert slab, keeping address order
+		size_type index_( slabsCount_ );
+		while ( index_ > 0 && slabs_[index_ - 1]->buffer_.data( ) > slab_->buffer_.data( ) )
+		{
+			slabs_[index_] = slabs_[index_ - 1];
+			index_--;
+		}
+		slabs_[index_] = slab_;
+		slabsCount_++;
+
+		// Increase blocks counters
+		count_ += pCount;
+		available_count_ += pCount;
+
+		// Next slab size
+		if ( growth_ == linear_allocator_growth::geometric && pCount > 0 )
+			nextCount_ = pCount * 2;
+
+		// Return slab
+		return( slab_ );
+
+	}
+
+	/*
+	 * Allocates several objects in the first run of contiguous available blocks (first-fit).
+	 *
+	 * (?) Run can't cross slabs, so slabs are checked one by one, then slab
+	 * large enough for the run is added by growth policy.
+	 *
+	 * @param pCount - number of elements, more than 1.
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	void * allocate_run( const size_type pCount )
+	{
+
+		// Free-list is ordered by release, not by address
+		if ( mode_ == linear_allocator_mode::free_list )
+			throw std::length_error( "linear_pool::allocate - free_list mode supports only one object allocation at once" );
+
+		// Check if exceeded
+		if ( pCount > max_size( ) || ( growth_ == linear_allocator_growth::none && blocks_for( pCount ) > available_count_ ) )
+			throw std::length_error( "linear_pool::allocate - maximum objects exceeded" );
+
+		// Blocks count
+		const size_type blocks_( blocks_for( pCount ) );
+
+		// Search run of available blocks in slabs
+		slab * slab_( nullptr );
+		size_type index_( linear_bitmap<>::NO_BIT );
+		for ( size_type i = 0; i < slabsCount_ && index_ == linear_bitmap<>::NO_BIT; i++ )
+		{
+			if ( slabs_[i]->available_count_ >= blocks_ )
+			{
+				slab_ = slabs_[i];
+				index_ = slab_->blocks_status_.find_zero_run( blocks_ );
+			}
+		}
+
+		// Available blocks are fragmented
+		if ( index_ == linear_bitmap<>::NO_BIT )
+		{
+
+			// Can't grow
+			if ( growth_ == linear_allocator_growth::none )
+				throw std::bad_alloc( );
+
+			// Add slab, large enough for the run
+			slab_ = add_slab( blocks_ > nextCount_ ? blocks_ : nextCount_ );
+			index_ = 0;
+
+		}
+
+		// Commit pages of the run
+		if ( !slab_->buffer_.commit( ( index_ + blocks_ ) * elementSize_ ) )
+			throw std::bad_alloc( );
+
+		// Pointer (address, offset) to the first block
+		void *const ptr_( slab_->buffer_.data( ) + ( index_ * elementSize_ ) );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::allocate - reserving " << std::to_string( blocks_ ) << " blocks from #" << std::to_string( index_ ) << " ; address=" << ptr_ << std::endl;
+#endif // DEBUG
+
+		// Reserve
+		slab_->blocks_status_.set_run( index_, blocks_ );
+
+		// Decrease available blocks counters
+		slab_->available_count_ -= blocks_;
+		available_count_ -= blocks_;
+
+		// Return pointer to the offset-address
+		return( ptr_ );
+
+	}
+
+	/*
+	 * Releases run of blocks, allocated for several objects.
+	 *
+	 * @param ptr_ - pointer to the first block.
+	 * @param pCount - number of elements, more than 1.
+	*/
+	void deallocate_run( const void *const ptr_, const size_type pCount ) noexcept
+	{
+
+		// Owning slab
+		slab *const slab_( find_slab( ptr_ ) );
+
+		// First block index
+		const size_type index_( slab_->index_of( ptr_ ) );
+
+		// Blocks count
+		const size_type blocks_( blocks_for( pCount ) );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool::deallocate - freeing " << std::to_string( blocks_ ) << " blocks from #" << std::to_string( index_ ) << std::endl;
+#endif // DEBUG
+
+		// Mark blocks as available
+		slab_->blocks_status_.reset_run( index_, blocks_ );
+		slab_->freedIndex_ = index_;
+
+		// Increase available blocks counters
+		slab_->available_count_ += blocks_;
+		available_count_ += blocks_;
+
+		// Allocate from this slab, when current one is full
+		if ( current_->available_count_ < 1 )
+			current_ = slab_;
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_pool const copy constructor */
+	linear_pool( const linear_pool & ) = delete;
+
+	/* @deleted linear_pool const copy assignment operator */
+	linear_pool & operator=( const linear_pool & ) = delete;
+
+	/* @deleted linear_pool move assignment operator */
+	linear_pool & operator=( linear_pool && ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_POOL_HPP
@@ -0,0 +1,306 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+#ifndef C0DE4UN_LINEAR_RESOURCE_HPP
+#define C0DE4UN_LINEAR_RESOURCE_HPP
+
+/* RESOURCES REQUIRED HEADERS */
+
+#include <cstddef> // size_t, max_align_t
+#include <memory_resource> // std::pmr::memory_resource
+
+#include "linear_pool.hpp" // linear_pool
+#include "linear_arena.hpp" // linear_arena
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF RESOURCES REQUIRED HEADERS */
+
+/*
+ * linear_pool_resource - std::pmr::memory_resource with fixed size slots.
+ *
+ * (?) Requests, which fit into the slot, are served by linear_pool in free_list mode,
+ * so node-based pmr containers (unordered_map, list, map) & short strings get O(1)
+ * allocation & deallocation. Larger, over-aligned requests, & requests
+ * to exhausted pool go to the upstream resource.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_pool_resource : public std::pmr::memory_resource
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_pool_resource constructor.
+	 *
+	 * @param pSlotSize - slot size in bytes.
+	 * @param pCount - slots count of the first slab.
+	 * @param pGrowth - growth policy, when all slots are reserved. Without growth upstream is used.
+	 * @param pAlignment - slots alignment, power of 2.
+	 * @param pUpstream - resource for requests, which don't fit into the slot.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
+	*/
+	linear_pool_resource( const std::size_t pSlotSize, const std::size_t pCount, const linear_allocator_growth pGrowth = linear_allocator_growth::none, const std::size_t pAlignment = alignof( std::max_align_t ), std::pmr::memory_resource *const pUpstream = std::pmr::get_default_resource( ) )
+		: pool_( pSlotSize, pCount, linear_allocator_mode::free_list, pGrowth, pAlignment ),
+		upstream_( pUpstream )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_pool_resource::constructor; slot_size=" << pSlotSize << "; slots: " << pCount << std::endl;
+#endif // DEBUG
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns slots pool */
+	const linear_pool & pool( ) const noexcept
+	{ return( pool_ ); }
+
+	/* Returns upstream resource */
+	std::pmr::memory_resource * upstream_resource( ) const noexcept
+	{ return( upstream_ ); }
+
+	// -------------------------------------------------------- \\
+
+protected:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// memory_resource
+	// ===========================================================
+
+	/*
+	 * Allocates bytes from the slot, or from upstream.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw std::bad_alloc
+	*/
+	void * do_allocate( const std::size_t pBytes, const std::size_t pAlign ) override
+	{
+
+		// Slot
+		if ( fits( pBytes, pAlign ) && !pool_.exhausted( ) )
+			return( pool_.allocate( ) );
+
+		// Upstream
+		return( upstream_->allocate( pBytes, pAlign ) );
+
+	}
+
+	/*
+	 * Releases bytes to the pool, or to upstream.
+	 *
+	 * (?) Exhausted pool sends slot-sized requests upstream, so owner is checked by address.
+	*/
+	void do_deallocate( void * ptr_, const std::size_t pBytes, const std::size_t pAlign ) override
+	{
+
+		// Slot
+		if ( fits( pBytes, pAlign ) && pool_.owns( ptr_ ) )
+		{
+			pool_.deallocate( ptr_ );
+			return;
+		}
+
+		// Upstream
+		upstream_->deallocate( ptr_, pBytes, pAlign );
+
+	}
+
+	/* Memory can be released only by this resource */
+	bool do_is_equal( const std::pmr::memory_resource & pOther ) const noexcept override
+	{ return( this == &pOther ); }
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Slots */
+	linear_pool pool_;
+
+	/* Resource for other requests */
+	std::pmr::memory_resource *const upstream_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns 'TRUE' if request fits into the slot */
+	bool fits( const std::size_t pBytes, const std::size_t pAlign ) const noexcept
+	{ return( pBytes <= pool_.object_size( ) && pAlign <= pool_.alignment( ) ); }
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_pool_resource const copy constructor */
+	linear_pool_resource( const linear_pool_resource & ) = delete;
+
+	/* @deleted linear_pool_resource const copy assignment operator */
+	linear_pool_resource & operator=( const linear_pool_resource & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+/*
+ * linear_arena_resource - std::pmr::memory_resource over bump-pointer arena.
+ *
+ * (?) Deallocation does nothing, memory is released all at once with release,
+ * like std::pmr::monotonic_buffer_resource, but arena is allocated once & reused.
+ * Requests to exhausted arena go to the upstream resource & are released to it.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_arena_resource : public std::pmr::memory_resource
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_arena_resource constructor.
+	 *
+	 * @param pSize - arena size in bytes.
+	 * @param pUpstream - resource for requests to exhausted arena.
+	 * @throws - can throw std::bad_alloc
+	*/
+	explicit linear_arena_resource( const std::size_t pSize, std::pmr::memory_resource *const pUpstream = std::pmr::get_default_resource( ) )
+		: arena_( pSize ),
+		upstream_( pUpstream )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_arena_resource::constructor; size=" << pSize << std::endl;
+#endif // DEBUG
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns arena */
+	const linear_arena & arena( ) const noexcept
+	{ return( arena_ ); }
+
+	/* Returns upstream resource */
+	std::pmr::memory_resource * upstream_resource( ) const noexcept
+	{ return( upstream_ ); }
+
+	/*
+	 * Releases arena memory at once.
+	 *
+	 * (!) Containers, which use this resource, must be destroyed or cleared first.
+	*/
+	void release( ) noexcept
+	{ arena_.reset( ); }
+
+	// -------------------------------------------------------- \\
+
+protected:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// memory_resource
+	// ===========================================================
+
+	/*
+	 * Allocates bytes from the arena, or from upstream.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw std::bad_alloc
+	*/
+	void * do_allocate( const std::size_t pBytes, const std::size_t pAlign ) override
+	{
+
+		// Arena
+		void *const ptr_( arena_.try_allocate( pBytes, pAlign ) );
+		if ( ptr_ != nullptr )
+			return( ptr_ );
+
+		// Upstream
+		return( upstream_->allocate( pBytes, pAlign ) );
+
+	}
+
+	/* Releases upstream bytes, arena bytes are released by release */
+	void do_deallocate( void * ptr_, const std::size_t pBytes, const std::size_t pAlign ) override
+	{
+
+		// Upstream
+		if ( !arena_.owns( ptr_ ) )
+			upstream_->deallocate( ptr_, pBytes, pAlign );
+
+	}
+
+	/* Memory can be released only by this resource */
+	bool do_is_equal( const std::pmr::memory_resource & pOther ) const noexcept override
+	{ return( this == &pOther ); }
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Arena */
+	linear_arena arena_;
+
+	/* Resource for requests to exhausted arena */
+	std::pmr::memory_resource *const upstream_;
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_arena_resource const copy constructor */
+	linear_arena_resource( const linear_arena_resource & ) = delete;
+
+	/* @deleted linear_arena_resource const copy assignment operator */
+	linear_arena_resource & operator=( const linear_arena_resource & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_RESOURCE_HPP
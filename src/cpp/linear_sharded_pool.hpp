@@ -0,0 +1,573 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+#ifndef C0DE4UN_LINEAR_SHARDED_POOL_HPP
+#define C0DE4UN_LINEAR_SHARDED_POOL_HPP
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/* SHARDED POOL REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free
+#include <cstddef> // size_t, max_align_t
+#include <cstdint> // uint32_t, uint64_t
+#include <cstdio> // fopen, fscanf, fclose
+#include <new> // new, std::bad_alloc
+#include <stdexcept> // std::length_error
+#include <thread> // thread::hardware_concurrency, this_thread::get_id
+#include <functional> // hash
+#include <atomic> // atomic
+
+#include "linear_buffer.hpp" // linear_buffer
+#include "linear_atomic_pool.hpp" // linear_atomic_pool
+#include "linear_numa.hpp" // linear_numa_node_of_cpu
+
+#if defined( __linux__ ) // LINUX
+
+#include <sched.h> // sched_getcpu
+
+#if __has_include( <sys/rseq.h> ) && ( defined( __x86_64__ ) || defined( __aarch64__ ) ) // RSEQ
+#include <sys/rseq.h> // rseq, __rseq_offset, __rseq_size
+#define __linear_allocator_rseq_enabled_
+#endif // RSEQ
+
+#endif // LINUX
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF SHARDED POOL REQUIRED HEADERS */
+
+/*
+ * Returns CPU number of the calling thread.
+ *
+ * (?) cpu_id field of restartable sequences area, registered by glibc, is read
+ * without system call. sched_getcpu is used, when rseq isn't registered.
+ * Other platforms get stable number of the thread instead of CPU.
+ *
+ * (!) Thread can migrate right after the call, so result is a hint.
+*/
+inline unsigned int linear_current_cpu( ) noexcept
+{
+
+#if defined( __linear_allocator_rseq_enabled_ ) // RSEQ
+	// Registered rseq area
+	if ( __rseq_size > 0 )
+	{
+
+		// CPU number, updated by kernel on migration
+		const volatile std::uint32_t *const cpu_( &reinterpret_cast<const struct rseq*>( static_cast<const char*>( __builtin_thread_pointer( ) ) + __rseq_offset )->cpu_id );
+		const std::uint32_t value_( *cpu_ );
+
+		// Negative values mean not registered
+		if ( static_cast<std::int32_t>( value_ ) >= 0 )
+			return( value_ );
+
+	}
+#endif // RSEQ
+
+#if defined( __linux__ ) // LINUX
+	// System call
+	const int cpu_( sched_getcpu( ) );
+	if ( cpu_ >= 0 )
+		return( static_cast<unsigned int>( cpu_ ) );
+#endif // LINUX
+
+	// Thread number
+	return( static_cast<unsigned int>( std::hash<std::thread::id>( )( std::this_thread::get_id( ) ) ) );
+
+}
+
+/*
+ * linear_sharded_pool - pool, split into lock-free shards, one per CPU.
+ *
+ * (?) Thread allocates from the shard of its current CPU, so threads on different
+ * cores don't touch the same free-list. Memory is bounded by CPUs count,
+ * not by threads count, unlike per-thread magazines.
+ *
+ * (?) Shard is linear_atomic_pool, so thread, migrated or preempted between CPU
+ * lookup & allocation, stays correct. Each shard head is on own cache line.
+ *
+ * (?) Empty shard steals from the next shards, one by one: shards of the same NUMA node
+ * first, then shards of other nodes.
+ *
+ * (?) Shards are split between NUMA nodes in proportion to CPUs count of the node, & CPU
+ * uses shard of its own node, whatever shards count & CPU numbering are. With NUMA binding,
+ * pages of each shard buffer are bound to the shard node, so allocation from the CPU shard
+ * returns memory of the caller's node.
+ *
+ * (?) Block is returned to the shard, which owns it, found by binary search
+ * of shard buffers, sorted by address.
+ *
+ * @config
+ * - _C0DE4UN_MULTITHREADING_ENABLED_ - required, pool isn't defined without it.
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_sharded_pool
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_sharded_pool constructor.
+	 *
+	 * @param pObjectSize - object size in bytes.
+	 * @param pCount - blocks count of each shard.
+	 * @param pShards - shards count, CPUs count is used when 0.
+	 * @param pAlignment - blocks alignment, power of 2.
+	 * @param pNumaBind - bind pages of each shard to its NUMA node.
+	 * @throws - can throw std::bad_alloc, std::length_error & std::invalid_argument
+	*/
+	linear_sharded_pool( const std::size_t pObjectSize, const std::size_t pCount, const std::size_t pShards = 0, const std::size_t pAlignment = alignof( std::max_align_t ), const bool pNumaBind = false )
+		: shardsCount_( shards_for( pShards ) ),
+		cpusCount_( cpus_limit( ) ),
+		storage_( shardsCount_ * sizeof( linear_atomic_pool ), alignof( linear_atomic_pool ) ),
+		shards_( reinterpret_cast<linear_atomic_pool*>( storage_.data( ) ) ),
+		sorted_( static_cast<linear_atomic_pool**>( std::malloc( shardsCount_ * sizeof( linear_atomic_pool* ) ) ) ),
+		nodes_( static_cast<int*>( std::malloc( shardsCount_ * sizeof( int ) ) ) ),
+		cpuShards_( static_cast<size_type*>( std::malloc( cpusCount_ * sizeof( size_type ) ) ) ),
+		steals_( 0 )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_sharded_pool::constructor; shards: " << shardsCount_ << "; elements: " << pCount << std::endl;
+#endif // DEBUG
+
+		// NUMA node of each CPU
+		int *const cpuNodes_( static_cast<int*>( std::malloc( cpusCount_ * sizeof( int ) ) ) );
+		if ( cpuNodes_ != nullptr )
+		{
+			for ( size_type i = 0; i < cpusCount_; i++ )
+				cpuNodes_[i] = linear_numa_node_of_cpu( static_cast<unsigned int>( i ) );
+		}
+
+		// Shard of each CPU & node of each shard
+		if ( sorted_ == nullptr || nodes_ == nullptr || cpuShards_ == nullptr || cpuNodes_ == nullptr || !map_cpus( cpuNodes_, cpusCount_, shardsCount_, cpuShards_, nodes_ ) )
+		{
+			std::free( cpuNodes_ );
+			std::free( sorted_ );
+			std::free( nodes_ );
+			std::free( cpuShards_ );
+			throw std::bad_alloc( );
+		}
+		std::free( cpuNodes_ );
+
+		// Construct shards
+		size_type constructed_ = 0;
+		try
+		{
+			for ( ; constructed_ < shardsCount_; constructed_++ )
+				new( shards_ + constructed_ ) linear_atomic_pool( pObjectSize, pCount, linear_allocator_mode::free_list, pAlignment, pNumaBind ? nodes_[constructed_] : LINEAR_NUMA_NO_NODE );
+		}
+		catch ( ... )
+		{
+			for ( size_type i = 0; i < constructed_; i++ )
+				shards_[i].~linear_atomic_pool( );
+			std::free( sorted_ );
+			std::free( nodes_ );
+			std::free( cpuShards_ );
+			throw;
+		}
+
+		// Sort shards by buffer address
+		for ( size_type i = 0; i < shardsCount_; i++ )
+		{
+			size_type index_( i );
+			while ( index_ > 0 && sorted_[index_ - 1]->data( ) > shards_[i].data( ) )
+			{
+				sorted_[index_] = sorted_[index_ - 1];
+				index_--;
+			}
+			sorted_[index_] = shards_ + i;
+		}
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/* linear_sharded_pool destructor */
+	~linear_sharded_pool( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_sharded_pool::destructor" << std::endl;
+#endif // DEBUG
+
+		// Destroy shards
+		for ( size_type i = 0; i < shardsCount_; i++ )
+			shards_[i].~linear_atomic_pool( );
+
+		// Release shards index, nodes & CPU shards
+		std::free( sorted_ );
+		std::free( nodes_ );
+		std::free( cpuShards_ );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns shards count */
+	size_type shards_count( ) const noexcept
+	{ return( shardsCount_ ); }
+
+	/* Returns shard */
+	const linear_atomic_pool & shard( const size_type pIndex ) const noexcept
+	{ return( shards_[pIndex] ); }
+
+	/* Returns NUMA node of the shard */
+	int shard_node( const size_type pIndex ) const noexcept
+	{ return( nodes_[pIndex] ); }
+
+	/*
+	 * Returns shard index of the calling thread CPU.
+	 *
+	 * (?) CPU number, which isn't possible CPU (thread number on other platforms), is wrapped.
+	*/
+	size_type current_shard( ) const noexcept
+	{
+		const unsigned int cpu_( linear_current_cpu( ) );
+		return( cpu_ < cpusCount_ ? cpuShards_[cpu_] : cpu_ % shardsCount_ );
+	}
+
+	/*
+	 * Maps CPUs to shards & shards to NUMA nodes.
+	 *
+	 * (?) Shards are split between nodes in proportion to CPUs count of the node (D'Hondt),
+	 * each node gets a shard first, while shards are enough. CPU takes shard of its node
+	 * by its index among CPUs of the node, so allocation prefers the caller's node.
+	 * CPUs of nodes without shard, when nodes are more than shards, use all shards.
+	 *
+	 * @param pCpuNodes - node of each CPU.
+	 * @param pCpus - CPUs count.
+	 * @param pShards - shards count, more than 0.
+	 * @param pCpuShards - receives shard of each CPU.
+	 * @param pShardNodes - receives node of each shard.
+	 * @return - 'FALSE' if temporary arrays can't be allocated.
+	*/
+	static bool map_cpus( const int *const pCpuNodes, const size_type pCpus, const size_type pShards, size_type *const pCpuShards, int *const pShardNodes ) noexcept
+	{
+
+		// Per-node arrays: node of the CPU, CPUs count, shards count, first shard & CPUs counter
+		size_type *const work_( static_cast<size_type*>( std::calloc( pCpus * 5 + 1, sizeof( size_type ) ) ) );
+		if ( work_ == nullptr )
+			return( false );
+		size_type *const cpuNode_( work_ );
+		size_type *const nodeCpus_( work_ + pCpus );
+		size_type *const nodeShards_( work_ + pCpus * 2 );
+		size_type *const nodeFirst_( work_ + pCpus * 3 );
+		size_type *const nodeSeen_( work_ + pCpus * 4 );
+
+		// Distinct nodes, first CPU of the node keeps its number
+		size_type nodesCount_( 0 );
+		for ( size_type i = 0; i < pCpus; i++ )
+		{
+			size_type node_( 0 );
+			while ( node_ < nodesCount_ && pCpuNodes[nodeFirst_[node_]] != pCpuNodes[i] )
+				node_++;
+			if ( node_ == nodesCount_ )
+				nodeFirst_[nodesCount_++] = i;
+			cpuNode_[i] = node_;
+			nodeCpus_[node_]++;
+		}
+
+		// Node numbers
+		for ( size_type n = 0; n < nodesCount_; n++ )
+			nodeSeen_[n] = static_cast<size_type>( pCpuNodes[nodeFirst_[n]] );
+
+		// Shard per node, then by the highest CPUs per shard
+		size_type shards_( 0 );
+		for ( ; shards_ < nodesCount_ && nodesCount_ <= pShards; shards_++ )
+			nodeShards_[shards_] = 1;
+		for ( ; shards_ < pShards && nodesCount_ > 0; shards_++ )
+		{
+			size_type best_( 0 );
+			for ( size_type n = 1; n < nodesCount_; n++ )
+			{
+				if ( nodeCpus_[n] * ( nodeShards_[best_] + 1 ) > nodeCpus_[best_] * ( nodeShards_[n] + 1 ) )
+					best_ = n;
+			}
+			nodeShards_[best_]++;
+		}
+
+		// Shards of each node are contiguous
+		for ( size_type n = 0, first_ = 0; n < nodesCount_; first_ += nodeShards_[n], n++ )
+		{
+			for ( size_type s = 0; s < nodeShards_[n]; s++ )
+				pShardNodes[first_ + s] = static_cast<int>( nodeSeen_[n] );
+			nodeFirst_[n] = first_;
+			nodeSeen_[n] = 0;
+		}
+
+		// Shards without CPUs
+		for ( size_type s = ( nodesCount_ > 0 ? nodeFirst_[nodesCount_ - 1] + nodeShards_[nodesCount_ - 1] : 0 ); s < pShards; s++ )
+			pShardNodes[s] = LINEAR_NUMA_NO_NODE;
+
+		// Shard of each CPU, by its index among CPUs of the node
+		for ( size_type i = 0; i < pCpus; i++ )
+		{
+			const size_type node_( cpuNode_[i] );
+			pCpuShards[i] = nodeShards_[node_] > 0 ? nodeFirst_[node_] + nodeSeen_[node_] % nodeShards_[node_] : i % pShards;
+			nodeSeen_[node_]++;
+		}
+
+		// Release
+		std::free( work_ );
+		return( true );
+
+	}
+
+	/*
+	 * Returns number of allocations, served by other shard, than shard of the CPU.
+	 *
+	 * (?) Counter is relaxed, value of other threads may come later.
+	*/
+	size_type steals( ) const noexcept
+	{ return( steals_.load( std::memory_order_relaxed ) ); }
+
+	/*
+	 * Allocates 1 block.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @throws - can throw std::length_error, when all shards are empty.
+	*/
+	void * allocate( )
+	{
+
+		// Pop block
+		void *const ptr_( try_allocate( ) );
+
+		// Check if exceeded
+		if ( ptr_ == nullptr )
+			throw std::length_error( "linear_sharded_pool::allocate - maximum objects exceeded" );
+
+		// Return pointer
+		return( ptr_ );
+
+	}
+
+	/*
+	 * Allocates 1 block from CPU shard, or steals from neighbours.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	 * @return - block, or nullptr when all shards are empty.
+	*/
+	void * try_allocate( ) noexcept
+	{
+
+		// Shard of the CPU
+		const size_type first_( current_shard( ) );
+		void * ptr_( shards_[first_].try_allocate( ) );
+		if ( ptr_ != nullptr )
+			return( ptr_ );
+
+		// Steal from the next shards of the same node, then of other nodes
+		for ( int pass_ = 0; pass_ < 2; pass_++ )
+		{
+			for ( size_type i = 1; i < shardsCount_; i++ )
+			{
+
+				// Shard of this pass
+				const size_type index_( ( first_ + i ) % shardsCount_ );
+				if ( ( nodes_[index_] == nodes_[first_] ) != ( pass_ == 0 ) )
+					continue;
+
+				// Steal
+				ptr_ = shards_[index_].try_allocate( );
+				if ( ptr_ != nullptr )
+				{
+					steals_.fetch_add( 1, std::memory_order_relaxed );
+					return( ptr_ );
+				}
+
+			}
+		}
+
+		// All shards are empty
+		return( nullptr );
+
+	}
+
+	/*
+	 * Deallocates 1 block to its shard.
+	 *
+	 * @thread_safety - thread-safe, lock-free.
+	*/
+	void deallocate( void *const ptr_ ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Return block
+		find_shard( ptr_ )->deallocate( ptr_ );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Shards count */
+	const std::size_t shardsCount_;
+
+	/* CPU numbers limit, highest possible CPU number + 1 */
+	const std::size_t cpusCount_;
+
+	/* Shards storage, aligned to cache line */
+	linear_buffer storage_;
+
+	/* Shards, grouped by node */
+	linear_atomic_pool *const shards_;
+
+	/* Shards, sorted by buffer address */
+	linear_atomic_pool ** sorted_;
+
+	/* NUMA node of each shard */
+	int * nodes_;
+
+	/* Shard of each CPU */
+	size_type * cpuShards_;
+
+	/* Steals counter */
+	alignas( linear_atomic_pool::CACHE_LINE_SIZE ) std::atomic<std::size_t> steals_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns shards count for the given value, CPUs count for 0 */
+	static std::size_t shards_for( const std::size_t pShards ) noexcept
+	{
+
+		// Given count
+		if ( pShards > 0 )
+			return( pShards );
+
+		// CPUs count
+		const unsigned int cpus_( std::thread::hardware_concurrency( ) );
+		return( cpus_ > 0 ? cpus_ : 1 );
+
+	}
+
+	/*
+	 * Returns CPU numbers limit.
+	 *
+	 * (?) Linux lists possible CPUs like '0-3,8-11', last number is the highest.
+	 * CPUs count is used, when list isn't available.
+	*/
+	static std::size_t cpus_limit( ) noexcept
+	{
+
+#if defined( __linux__ ) // LINUX
+		// Possible CPUs list
+		std::FILE *const file_( std::fopen( "/sys/devices/system/cpu/possible", "r" ) );
+		if ( file_ != nullptr )
+		{
+
+			// Last number
+			unsigned int value_( 0 );
+			unsigned int last_( 0 );
+			bool read_( false );
+			char separator_( 0 );
+			while ( std::fscanf( file_, "%u", &value_ ) == 1 )
+			{
+				last_ = value_;
+				read_ = true;
+				if ( std::fscanf( file_, "%c", &separator_ ) != 1 )
+					break;
+			}
+			std::fclose( file_ );
+
+			// Return limit
+			if ( read_ )
+				return( static_cast<std::size_t>( last_ ) + 1 );
+
+		}
+#endif // LINUX
+
+		// CPUs count
+		const unsigned int cpus_( std::thread::hardware_concurrency( ) );
+		return( cpus_ > 0 ? cpus_ : 1 );
+
+	}
+
+	/*
+	 * Returns shard, which owns the given pointer.
+	 *
+	 * (?) O(log shards).
+	*/
+	linear_atomic_pool * find_shard( const void *const ptr_ ) const noexcept
+	{
+
+		// Search last shard, which buffer starts before the pointer
+		size_type first_ = 0;
+		size_type last_ = shardsCount_;
+		while ( last_ - first_ > 1 )
+		{
+
+			// Middle shard
+			const size_type middle_( first_ + ( last_ - first_ ) / 2 );
+
+			// Go right or left
+			if ( static_cast<const unsigned char*>( ptr_ ) >= sorted_[middle_]->data( ) )
+				first_ = middle_;
+			else
+				last_ = middle_;
+
+		}
+
+		// Return shard
+		return( sorted_[first_] );
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_sharded_pool const copy constructor */
+	linear_sharded_pool( const linear_sharded_pool & ) = delete;
+
+	/* @deleted linear_sharded_pool const copy assignment operator */
+	linear_sharded_pool & operator=( const linear_sharded_pool & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // MULTITHREADING
+
+#endif // !C0DE4UN_LINEAR_SHARDED_POOL_HPP
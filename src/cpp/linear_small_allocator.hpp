@@ -0,0 +1,368 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+#ifndef C0DE4UN_LINEAR_SMALL_ALLOCATOR_HPP
+#define C0DE4UN_LINEAR_SMALL_ALLOCATOR_HPP
+
+/* SMALL ALLOCATOR REQUIRED HEADERS */
+
+#include <cstdlib> // malloc & free
+#include <cstddef> // size_t, max_align_t
+#include <new> // new, std::bad_alloc, std::align_val_t
+#include <stdexcept> // std::length_error
+
+#include "linear_pool.hpp" // linear_pool
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF SMALL ALLOCATOR REQUIRED HEADERS */
+
+/*
+ * linear_small_allocator - allocator of small objects with different sizes.
+ *
+ * (?) Request is rounded up to the size class, each class has own linear_pool
+ * in free_list mode, created on the first request of the class. Classes are 8 & 16 bytes,
+ * then 16 bytes steps up to 128, then 4 classes per power of 2 up to 1024 bytes,
+ * so rounding wastes less than 25% above 128 bytes.
+ *
+ * (?) Block alignment is the largest power of 2, which divides class size, at least
+ * 16 bytes for classes above 8. Request with larger alignment goes to the next class,
+ * which size is multiple of the alignment.
+ *
+ * (?) Requests above MAX_SIZE go to the global heap.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_small_allocator
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* size_type type-alias */
+	using size_type = std::size_t;
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Classes count */
+	static constexpr size_type CLASSES_COUNT = 21;
+
+	/* Largest class size in bytes */
+	static constexpr size_type MAX_SIZE = 1024;
+
+	/* Default slab size in bytes, large slabs keep slabs search short */
+	static constexpr size_type DEFAULT_SLAB_SIZE = 256 * 1024;
+
+	/* Invalid class index, used for heap requests */
+	static constexpr size_type NO_CLASS = static_cast<size_type>( -1 );
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_small_allocator constructor.
+	 *
+	 * (?) Pools aren't created until the first request of the class.
+	 *
+	 * @param pSlabSize - slab size in bytes of each class, at least one block.
+	*/
+	explicit linear_small_allocator( const size_type pSlabSize = DEFAULT_SLAB_SIZE ) noexcept
+		: slabSize_( pSlabSize ),
+		pools_( ),
+		heapCount_( 0 )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_small_allocator::constructor; slab_size=" << slabSize_ << std::endl;
+#endif // DEBUG
+
+	}
+
+	// ===========================================================
+	// Destructor
+	// ===========================================================
+
+	/*
+	 * linear_small_allocator destructor.
+	 *
+	 * (!) Heap blocks, which weren't deallocated, aren't released.
+	*/
+	~linear_small_allocator( )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_small_allocator::destructor" << std::endl;
+#endif // DEBUG
+
+		// Release pools
+		for ( linear_pool *const pool_ : pools_ )
+		{
+			if ( pool_ != nullptr )
+			{
+				pool_->~linear_pool( );
+				std::free( pool_ );
+			}
+		}
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns size in bytes of the class */
+	static size_type class_size( const size_type pClass ) noexcept
+	{ return( CLASS_SIZES[pClass] ); }
+
+	/*
+	 * Returns class index for the given request, or NO_CLASS for heap request.
+	 *
+	 * (?) Class of the size is computed without table: 16 bytes steps up to 128,
+	 * then power of 2 of the size & 2 bits below it select 1 of 4 classes.
+	 *
+	 * @param pBytes - size in bytes.
+	 * @param pAlign - alignment, power of 2, or 0 for malloc alignment.
+	*/
+	static size_type class_of( const size_type pBytes, const size_type pAlign = 0 ) noexcept
+	{
+
+		// Heap request
+		if ( pBytes > MAX_SIZE )
+			return( NO_CLASS );
+
+		// Class of the size
+		size_type class_( 0 );
+		if ( pBytes > 128 )
+		{
+			const size_type last_( pBytes - 1 );
+			const size_type power_( 7 + ( last_ >= 256 ) + ( last_ >= 512 ) );
+			class_ = 9 + 4 * ( power_ - 7 ) + ( ( last_ >> ( power_ - 2 ) ) & 3 );
+		}
+		else if ( pBytes > 8 )
+			class_ = ( pBytes + 15 ) / 16;
+
+		// Class, which size is multiple of the alignment
+		const size_type align_( required_align( pBytes, pAlign ) );
+		while ( class_ < CLASSES_COUNT && CLASS_SIZES[class_] % align_ != 0 )
+			class_++;
+
+		// Return class
+		return( class_ < CLASSES_COUNT ? class_ : NO_CLASS );
+
+	}
+
+	/* Returns pool of the class, or nullptr if it wasn't created yet */
+	const linear_pool * pool( const size_type pClass ) const noexcept
+	{ return( pools_[pClass] ); }
+
+	/* Returns number of heap blocks, which weren't deallocated */
+	size_type heap_count( ) const noexcept
+	{ return( heapCount_ ); }
+
+	/*
+	 * Allocates bytes.
+	 *
+	 * (?) Default alignment is malloc guarantee: requests up to 8 bytes are aligned to 8,
+	 * others to alignof( std::max_align_t ).
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pBytes - size in bytes.
+	 * @param pAlign - alignment, power of 2, or 0 for malloc alignment.
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	void * allocate( const size_type pBytes, const size_type pAlign = 0 )
+	{
+
+		// Class
+		const size_type class_( class_of( pBytes, pAlign ) );
+
+		// Heap request
+		if ( class_ == NO_CLASS )
+			return( allocate_heap( pBytes, pAlign ) );
+
+		// Pool of the class
+		linear_pool *& pool_( pools_[class_] );
+		if ( pool_ == nullptr )
+			pool_ = create_pool( class_ );
+
+		// Allocate block
+		return( pool_->allocate( ) );
+
+	}
+
+	/*
+	 * Deallocates bytes.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param ptr_ - pointer, returned by allocate.
+	 * @param pBytes - size in bytes, same as allocated.
+	 * @param pAlign - alignment, same as allocated.
+	*/
+	void deallocate( void *const ptr_, const size_type pBytes, const size_type pAlign = 0 ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Class
+		const size_type class_( class_of( pBytes, pAlign ) );
+
+		// Heap request
+		if ( class_ == NO_CLASS )
+		{
+			deallocate_heap( ptr_, pAlign );
+			return;
+		}
+
+		// Release block
+		pools_[class_]->deallocate( ptr_ );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Size classes in bytes */
+	static constexpr size_type CLASS_SIZES[CLASSES_COUNT] = { 8, 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024 };
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Slab size in bytes */
+	const size_type slabSize_;
+
+	/* Pools of classes */
+	linear_pool * pools_[CLASSES_COUNT];
+
+	/* Heap blocks count */
+	size_type heapCount_;
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns alignment, required by the request.
+	 *
+	 * (?) Request up to 8 bytes can't contain object with larger alignment, so
+	 * default alignment is reduced to 8 for it.
+	*/
+	static size_type required_align( const size_type pBytes, const size_type pAlign ) noexcept
+	{
+		if ( pAlign > 0 )
+			return( pAlign );
+		return( pBytes <= CLASS_SIZES[0] ? CLASS_SIZES[0] : alignof( std::max_align_t ) );
+	}
+
+	/*
+	 * Creates pool of the class.
+	 *
+	 * @throws - can throw std::bad_alloc & std::length_error
+	*/
+	linear_pool * create_pool( const size_type pClass )
+	{
+
+		// Class size & alignment
+		const size_type size_( CLASS_SIZES[pClass] );
+		const size_type alignment_( size_ & ( ~size_ + 1 ) );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_small_allocator::create_pool - class #" << pClass << "; size=" << size_ << std::endl;
+#endif // DEBUG
+
+		// Allocate pool
+		void *const memory_( std::malloc( sizeof( linear_pool ) ) );
+		if ( memory_ == nullptr )
+			throw std::bad_alloc( );
+
+		// Construct pool
+		try
+		{
+			return( new( memory_ ) linear_pool( size_, slabSize_ > size_ ? slabSize_ / size_ : 1, linear_allocator_mode::free_list, linear_allocator_growth::fixed, alignment_ ) );
+		}
+		catch ( ... )
+		{
+			std::free( memory_ );
+			throw;
+		}
+
+	}
+
+	/*
+	 * Allocates heap block.
+	 *
+	 * @throws - can throw std::bad_alloc
+	*/
+	void * allocate_heap( const size_type pBytes, const size_type pAlign )
+	{
+
+		// Allocate
+		void *const ptr_( pAlign > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? ::operator new( pBytes, std::align_val_t( pAlign ) ) : ::operator new( pBytes ) );
+
+		// Count block
+		heapCount_++;
+
+		// Return pointer
+		return( ptr_ );
+
+	}
+
+	/* Releases heap block */
+	void deallocate_heap( void *const ptr_, const size_type pAlign ) noexcept
+	{
+
+		// Release
+		if ( pAlign > __STDCPP_DEFAULT_NEW_ALIGNMENT__ )
+			::operator delete( ptr_, std::align_val_t( pAlign ) );
+		else
+			::operator delete( ptr_ );
+
+		// Count block
+		heapCount_--;
+
+	}
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_small_allocator const copy constructor */
+	linear_small_allocator( const linear_small_allocator & ) = delete;
+
+	/* @deleted linear_small_allocator const copy assignment operator */
+	linear_small_allocator & operator=( const linear_small_allocator & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_SMALL_ALLOCATOR_HPP
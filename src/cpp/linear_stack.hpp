@@ -0,0 +1,216 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 11
+*/
+
+#ifndef C0DE4UN_LINEAR_STACK_HPP
+#define C0DE4UN_LINEAR_STACK_HPP
+
+/* STACK REQUIRED HEADERS */
+
+#include <cstddef> // size_t, max_align_t
+#include <cstdint> // uintptr_t
+#include <cstring> // memcpy
+#include <cassert> // assert
+#include <stdexcept> // std::length_error
+
+#include "linear_buffer.hpp" // linear_buffer
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+
+#include <iostream> // cout
+
+#endif // DEBUG
+
+/* END OF STACK REQUIRED HEADERS */
+
+/*
+ * linear_stack - stack (LIFO) allocator.
+ *
+ * (?) Every allocation is preceded by a small header with the previous stack state,
+ * so releasing the last allocation is O(1). Allocations must be released
+ * in reverse order, what is checked with assert in debug builds.
+ *
+ * @config
+ * - __linear_allocator_debug_enabled_ - enable log-output using STL cout.
+*/
+class linear_stack
+{
+
+public:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructors
+	// ===========================================================
+
+	/*
+	 * linear_stack constructor.
+	 *
+	 * @param pSize - size in bytes.
+	 * @throws - can throw std::bad_alloc
+	*/
+	explicit linear_stack( const std::size_t pSize )
+		: buffer_( pSize ),
+		offset_( 0 ),
+		top_( NO_TOP )
+	{
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_stack::constructor; size=" << pSize << std::endl;
+#endif // DEBUG
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Returns size in bytes */
+	std::size_t capacity( ) const noexcept
+	{ return( buffer_.size( ) ); }
+
+	/* Returns used bytes count, including headers & alignment padding */
+	std::size_t used( ) const noexcept
+	{ return( offset_ ); }
+
+	/*
+	 * Allocates bytes on top of the stack.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - size in bytes.
+	 * @param pAlign - alignment, power of 2.
+	 * @throws - can throw std::length_error, when stack is exhausted.
+	*/
+	void * allocate( const std::size_t pSize, const std::size_t pAlign = alignof( std::max_align_t ) )
+	{
+
+		// Aligned offset of the allocation, header is placed right before it
+		const std::uintptr_t address_( reinterpret_cast<std::uintptr_t>( buffer_.data( ) ) + offset_ + sizeof( header ) );
+		const std::size_t offset_aligned_( offset_ + sizeof( header ) + static_cast<std::size_t>( ( ( address_ + pAlign - 1 ) & ~static_cast<std::uintptr_t>( pAlign - 1 ) ) - address_ ) );
+
+		// Check if exceeded
+		if ( offset_aligned_ > buffer_.size( ) || pSize > buffer_.size( ) - offset_aligned_ )
+			throw std::length_error( "linear_stack::allocate - stack size exceeded" );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_stack::allocate - " << pSize << " bytes at offset " << offset_aligned_ << std::endl;
+#endif // DEBUG
+
+		// Store previous state
+		const header header_ = { offset_, top_ };
+		std::memcpy( buffer_.data( ) + offset_aligned_ - sizeof( header ), &header_, sizeof( header ) );
+
+		// Push
+		top_ = offset_aligned_;
+		offset_ = offset_aligned_ + pSize;
+
+		// Return pointer
+		return( buffer_.data( ) + offset_aligned_ );
+
+	}
+
+	/*
+	 * Releases the last allocation.
+	 *
+	 * (!) Only the last (top) allocation can be released, other pointers are caught by assert.
+	 *
+	 * @param ptr_ - pointer, returned by allocate.
+	*/
+	void deallocate( void *const ptr_, const std::size_t = 0 ) noexcept
+	{
+
+		// Nothing was allocated
+		if ( ptr_ == nullptr )
+			return;
+
+		// Allocation offset
+		const std::size_t offset_allocation_( static_cast<std::size_t>( static_cast<unsigned char*>( ptr_ ) - buffer_.data( ) ) );
+
+		// LIFO order is violated
+		assert( offset_allocation_ == top_ && "linear_stack::deallocate - not the last allocation" );
+
+#ifdef __linear_allocator_debug_enabled_ // DEBUG
+		// Print message
+		std::cout << "linear_stack::deallocate - offset " << offset_allocation_ << std::endl;
+#endif // DEBUG
+
+		// Restore previous state
+		header header_;
+		std::memcpy( &header_, buffer_.data( ) + offset_allocation_ - sizeof( header ), sizeof( header ) );
+
+		// Pop
+		offset_ = header_.offset_;
+		top_ = header_.top_;
+
+	}
+
+	/* Releases everything at once */
+	void reset( ) noexcept
+	{
+		offset_ = 0;
+		top_ = NO_TOP;
+	}
+
+	// -------------------------------------------------------- \\
+
+private:
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* Stack state, stored before each allocation */
+	struct header
+	{
+
+		/* Offset of the first available byte */
+		std::size_t offset_;
+
+		/* Offset of the last allocation */
+		std::size_t top_;
+
+	};
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Offset of the last allocation, when stack is empty */
+	static constexpr std::size_t NO_TOP = static_cast<std::size_t>( -1 );
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Buffer */
+	linear_buffer buffer_;
+
+	/* Offset of the first available byte */
+	std::size_t offset_;
+
+	/* Offset of the last allocation */
+	std::size_t top_;
+
+	// ===========================================================
+	// Deleted
+	// ===========================================================
+
+	/* @deleted linear_stack const copy constructor */
+	linear_stack( const linear_stack & ) = delete;
+
+	/* @deleted linear_stack const copy assignment operator */
+	linear_stack & operator=( const linear_stack & ) = delete;
+
+	// -------------------------------------------------------- \\
+
+};
+
+#endif // !C0DE4UN_LINEAR_STACK_HPP
@@ -14,10 +14,161 @@
 // Include STL
 #include <iostream> // cout, cin, cin.get
 #include <cstdlib> // std
+#include <cstdint> // uintptr_t
+#include <cstring> // memset
+#include <list> // list
+#include <map> // map
+#include <unordered_map> // unordered_map
+#include <vector> // vector
+#include <functional> // less, hash, equal_to
+#include <random> // mt19937
+
+// Include linear_bitmap
+#include "linear_bitmap.hpp"
 
 // Include linear_allocator
 #include "linear_allocator.hpp"
 
+// Include linear_arena
+#include "linear_arena.hpp"
+
+// Include linear_stack
+#include "linear_stack.hpp"
+
+// Include linear_frame
+#include "linear_frame.hpp"
+
+// Include linear_resource
+#include "linear_resource.hpp"
+
+// Include linear_small_allocator
+#include "linear_small_allocator.hpp"
+
+// Include linear_memory
+#include "linear_memory.hpp"
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+// Include STL thread
+#include <thread> // thread
+#include <atomic> // atomic
+#include <mutex> // mutex, lock_guard
+#include <algorithm> // sort, unique
+
+// Include linear_depot
+#include "linear_depot.hpp"
+
+// Include linear_atomic_pool
+#include "linear_atomic_pool.hpp"
+
+// Include linear_owned_pool
+#include "linear_owned_pool.hpp"
+
+// Include linear_sharded_pool
+#include "linear_sharded_pool.hpp"
+
+// Include linear_heap
+#include "linear_heap.hpp"
+
+#endif // MULTITHREADING
+
+// ===========================================================
+// Checks
+// ===========================================================
+
+/* Failed checks count, non-zero fails the run */
+static int failures_ = 0;
+
+/* Prints & counts failed check */
+static void check( const bool pCondition, const char *const pName )
+{
+	if ( !pCondition )
+	{
+		std::cout << "CHECK FAILED: " << pName << std::endl;
+		failures_++;
+	}
+}
+
+/*
+ * Linear-Bitmap tests.
+ *
+ * (?) Runs search is compared with naive first-fit search on random bits,
+ * with & without summary levels.
+*/
+template <bool SUMMARY>
+static void linear_bitmap_test( const char *const pName )
+{
+
+	// Run below the hint word of flat scan
+	linear_bitmap<SUMMARY> hinted_( 256 );
+	hinted_.set_run( 0, 256 );
+	hinted_.reset( 200 );
+	hinted_.find_first_zero( );
+	hinted_.reset_run( 0, 10 );
+	check( hinted_.find_zero_run( 4 ) == 0, "linear_bitmap::find_zero_run - run below the hint" );
+
+	// Random bits
+	constexpr std::size_t BITS = 1000;
+	std::mt19937 random_( 7 );
+	std::size_t mismatches_( 0 );
+	std::size_t nextMismatches_( 0 );
+	for ( int round_ = 0; round_ < 200; round_++ )
+	{
+
+		// Random model, bit in the upper half is available
+		std::vector<bool> model_( BITS, false );
+		for ( std::size_t i = 0; i < BITS; i++ )
+			model_[i] = random_( ) % 4 != 0;
+		const std::size_t hint_( BITS / 2 + random_( ) % ( BITS / 2 ) );
+		model_[hint_] = false;
+
+		// Full bitmap, search moves hint to the upper half, then model bits are cleared
+		linear_bitmap<SUMMARY> bitmap_( BITS );
+		bitmap_.set_run( 0, BITS );
+		bitmap_.reset( hint_ );
+		bitmap_.find_first_zero( );
+		for ( std::size_t i = 0; i < BITS; i++ )
+		{
+			if ( !model_[i] )
+				bitmap_.reset( i );
+		}
+
+		// Compare runs search
+		for ( std::size_t count_ = 2; count_ < 80; count_ += 7 )
+		{
+			std::size_t expected_( linear_bitmap<SUMMARY>::NO_BIT );
+			for ( std::size_t i = 0, run_ = 0; i < BITS && expected_ == linear_bitmap<SUMMARY>::NO_BIT; i++ )
+			{
+				run_ = model_[i] ? 0 : run_ + 1;
+				if ( run_ == count_ )
+					expected_ = i + 1 - count_;
+			}
+			mismatches_ += bitmap_.find_zero_run( count_ ) != expected_ ? 1 : 0;
+		}
+
+		// Compare next bit search, bits count is returned when there is no such bit
+		for ( std::size_t start_ = 0; start_ < BITS; start_ += 13 )
+		{
+			std::size_t zero_( start_ );
+			std::size_t one_( start_ );
+			while ( zero_ < BITS && model_[zero_] )
+				zero_++;
+			while ( one_ < BITS && !model_[one_] )
+				one_++;
+			const std::size_t foundZero_( bitmap_.find_next_zero( start_ ) );
+			const std::size_t foundOne_( bitmap_.find_next_one( start_ ) );
+			nextMismatches_ += ( foundZero_ < BITS ? foundZero_ : BITS ) != zero_ || ( foundOne_ < BITS ? foundOne_ : BITS ) != one_ ? 1 : 0;
+		}
+
+	}
+	check( mismatches_ == 0, "linear_bitmap::find_zero_run - first-fit run" );
+	check( nextMismatches_ == 0, "linear_bitmap::find_next_zero & find_next_one" );
+
+	// Print result
+	std::cout << pName << " runs search mismatches=" << mismatches_ << std::endl;
+
+}
+
 /*
  * Linear-Allocator tests.
 */
@@ -42,14 +193,758 @@ static void linear_allocator_test( )
 	// Print available blocks count
 	std::cout << "linear allocator available block=" << allocator_.available_size( ) << " after allocation of 1 object" << std::endl;
 
-	// Deallocate & destroy
+	// Destroy & deallocate
+	allocator_.destroy( n_ );
 	allocator_.deallocate( n_ );
 
 	// Print available blocks count
 	std::cout << "linear allocator available block=" << allocator_.available_size( ) << " after deallocation of 1 object" << std::endl;
 
+	// Allocate array of 4 objects
+	double *const array_ = allocator_.allocate( 4 );
+
+	// Construct doubles
+	for ( int i = 0; i < 4; i++ )
+		allocator_.construct( array_ + i, i * 0.5 );
+
+	// Print available blocks count
+	std::cout << "linear allocator available block=" << allocator_.available_size( ) << " after allocation of 4 objects" << std::endl;
+
+	// Deallocate array
+	allocator_.deallocate( array_, 4 );
+
+	// Print available blocks count
+	std::cout << "linear allocator available block=" << allocator_.available_size( ) << " after deallocation of 4 objects" << std::endl;
+
+}
+
+/*
+ * Linear-Allocator STL containers tests.
+ *
+ * (?) Containers rebind allocator to own node types, nodes are stored in pools of one group.
+*/
+static void linear_allocator_containers_test( )
+{
+
+	// Create linear_allocator instance, growth is required for buckets arrays
+	linear_allocator<int> allocator_( 64, linear_allocator_mode::bitmap, linear_allocator_growth::geometric );
+
+	// List with pooled nodes
+	std::list<int, linear_allocator<int>> list_( allocator_ );
+	for ( int i = 0; i < 16; i++ )
+		list_.push_back( i );
+
+	// Map with pooled nodes
+	using map_value = std::pair<const int, double>;
+	std::map<int, double, std::less<int>, linear_allocator<map_value>> map_( allocator_ );
+	for ( int i = 0; i < 16; i++ )
+		map_[i] = i * 0.5;
+
+	// Unordered map with pooled nodes & buckets
+	std::unordered_map<int, double, std::hash<int>, std::equal_to<int>, linear_allocator<map_value>> hash_map_( 16, std::hash<int>( ), std::equal_to<int>( ), allocator_ );
+	for ( int i = 0; i < 16; i++ )
+		hash_map_[i] = i * 0.5;
+
+	// Vector, copy shares pools
+	std::vector<int, linear_allocator<int>> vector_( list_.begin( ), list_.end( ), allocator_ );
+	std::vector<int, linear_allocator<int>> copy_( vector_ );
+
+	// Print containers sizes
+	std::cout << "linear allocator containers list=" << list_.size( ) << "; map=" << map_.size( ) << "; unordered_map=" << hash_map_.size( ) << "; vector=" << copy_.size( ) << std::endl;
+
+	// Print equality of rebound allocators
+	std::cout << "linear allocator map allocator equals list allocator=" << ( map_.get_allocator( ) == list_.get_allocator( ) ) << std::endl;
+
+	// Print int blocks, reserved by vectors
+	std::cout << "linear allocator reserved int blocks=" << allocator_.reserved_size( ) << std::endl;
+
+}
+
+/* 32-bytes aligned vector, like AVX register */
+struct alignas( 32 ) vector8f
+{
+	float values_[8];
+};
+
+/*
+ * Linear-Allocator alignment tests.
+*/
+static void linear_allocator_alignment_test( )
+{
+
+	// Create linear_allocator instance for over-aligned type
+	linear_allocator<vector8f> vectors_( 16 );
+
+	// Allocate 1 object
+	vector8f *const vector_ = vectors_.allocate( );
+
+	// Print alignment offset
+	std::cout << "linear allocator vector8f address % 32=" << reinterpret_cast<std::uintptr_t>( vector_ ) % 32 << std::endl;
+
+	// Deallocate
+	vectors_.deallocate( vector_ );
+
+	// Create linear_allocator instance with blocks, padded to cache line
+	linear_allocator<int> counters_( 16, linear_allocator_mode::free_list, linear_allocator_growth::none, linear_allocator<int>::CACHE_LINE_SIZE );
+
+	// Allocate 2 objects
+	int *const first_ = counters_.allocate( );
+	int *const second_ = counters_.allocate( );
+
+	// Print distance
+	std::cout << "linear allocator padded counters distance=" << reinterpret_cast<std::uintptr_t>( second_ ) - reinterpret_cast<std::uintptr_t>( first_ ) << " bytes" << std::endl;
+
+	// Deallocate
+	counters_.deallocate( second_ );
+	counters_.deallocate( first_ );
+
+}
+
+/*
+ * Linear-Arena tests.
+*/
+static void linear_arena_test( )
+{
+
+	// Create linear_arena instance
+	linear_arena arena_( 256 );
+
+	// Allocate 1 object
+	double *const n_ = static_cast<double*>( arena_.allocate( sizeof( double ), alignof( double ) ) );
+	*n_ = 777.7;
+
+	// Remember arena state
+	const linear_arena::marker marker_ = arena_.mark( );
+
+	// Allocate scratch memory
+	arena_.allocate( 100 );
+
+	// Print used bytes count
+	std::cout << "linear arena used bytes=" << arena_.used( ) << " after allocation of scratch memory" << std::endl;
+
+	// Release scratch memory
+	arena_.rewind( marker_ );
+
+	// Print used bytes count
+	std::cout << "linear arena used bytes=" << arena_.used( ) << " after rewind" << std::endl;
+
+	// Release everything
+	arena_.reset( );
+
+	// Print used bytes count
+	std::cout << "linear arena used bytes=" << arena_.used( ) << " after reset" << std::endl;
+
+}
+
+/*
+ * Linear-Stack tests.
+*/
+static void linear_stack_test( )
+{
+
+	// Create linear_stack instance
+	linear_stack stack_( 256 );
+
+	// Allocate 2 buffers
+	void *const first_ = stack_.allocate( 10 );
+	void *const second_ = stack_.allocate( 32, 32 );
+
+	// Print used bytes count
+	std::cout << "linear stack used bytes=" << stack_.used( ) << " after allocation of 2 buffers" << std::endl;
+
+	// Deallocate in reverse order
+	stack_.deallocate( second_ );
+	stack_.deallocate( first_ );
+
+	// Print used bytes count
+	std::cout << "linear stack used bytes=" << stack_.used( ) << " after deallocation of 2 buffers" << std::endl;
+
+}
+
+/*
+ * Linear-Frame tests.
+*/
+static void linear_frame_test( )
+{
+
+	// Create linear_frame instance
+	linear_frame frame_( 256 );
+
+	// Run 3 ticks
+	for ( int i = 1; i <= 3; i++ )
+	{
+
+		// Allocate data of the tick
+		frame_.allocate( 16 * i );
+
+		// Finish tick
+		frame_.next_tick( );
+
+	}
+
+	// Print high-water mark
+	std::cout << "linear frame high-water bytes=" << frame_.high_water( ) << " after " << frame_.ticks( ) << " ticks" << std::endl;
+
+}
+
+/*
+ * Linear-Resource tests.
+*/
+static void linear_resource_test( )
+{
+
+	// Create linear_pool_resource instance, 64 slots of 64 bytes
+	linear_pool_resource pool_( 64, 64 );
+
+	// Unordered map with pooled nodes
+	std::pmr::unordered_map<int, double> map_( &pool_ );
+	for ( int i = 0; i < 16; i++ )
+		map_[i] = i * 0.5;
+
+	// Print reserved slots count
+	std::cout << "linear pool resource reserved slots=" << pool_.pool( ).reserved_size( ) << " after insertion of " << map_.size( ) << " nodes" << std::endl;
+
+	// Create linear_arena_resource instance
+	linear_arena_resource arena_( 1024 );
+
+	{
+		// Vector in the arena
+		std::pmr::vector<int> vector_( &arena_ );
+		vector_.reserve( 16 );
+
+		// Print used bytes count
+		std::cout << "linear arena resource used bytes=" << arena_.arena( ).used( ) << " after reserve of 16 ints" << std::endl;
+	}
+
+	// Release arena
+	arena_.release( );
+
+	// Print used bytes count
+	std::cout << "linear arena resource used bytes=" << arena_.arena( ).used( ) << " after release" << std::endl;
+
+}
+
+/*
+ * Linear-Small-Allocator tests.
+*/
+static void linear_small_allocator_test( )
+{
+
+	// Create linear_small_allocator instance
+	linear_small_allocator allocator_;
+
+	// Allocate different sizes
+	void *const small_( allocator_.allocate( 5 ) );
+	void *const medium_( allocator_.allocate( 100 ) );
+	void *const aligned_( allocator_.allocate( 40, 64 ) );
+	void *const large_( allocator_.allocate( 4096 ) );
+
+	// Print classes
+	std::cout << "linear small allocator class size of 5 bytes=" << linear_small_allocator::class_size( allocator_.class_of( 5 ) ) << "; of 100 bytes=" << linear_small_allocator::class_size( allocator_.class_of( 100 ) ) << "; of 40 bytes aligned to 64=" << linear_small_allocator::class_size( allocator_.class_of( 40, 64 ) ) << std::endl;
+
+	// Print alignment & heap blocks
+	std::cout << "linear small allocator aligned=" << ( reinterpret_cast<std::uintptr_t>( aligned_ ) % 64 == 0 ) << "; heap blocks=" << allocator_.heap_count( ) << std::endl;
+
+	// Deallocate
+	allocator_.deallocate( small_, 5 );
+	allocator_.deallocate( medium_, 100 );
+	allocator_.deallocate( aligned_, 40, 64 );
+	allocator_.deallocate( large_, 4096 );
+
+	// Print heap blocks
+	std::cout << "linear small allocator heap blocks=" << allocator_.heap_count( ) << " after deallocation" << std::endl;
+
+}
+
+/*
+ * Linear-Pool lazy commit & page release tests.
+*/
+static void linear_pool_commit_test( )
+{
+
+	// Blocks of 64 bytes, 16 MiB of address space per pool
+	constexpr std::size_t COUNT = 256 * 1024;
+	std::vector<void*> blocks_( COUNT / 2, nullptr );
+
+	// Create lazy pools
+	const std::size_t rss_ = linear_resident_size( );
+	linear_pool bitmap_( 64, COUNT, linear_allocator_mode::bitmap, linear_allocator_growth::none, 64, linear_allocator_commit::lazy );
+	linear_pool free_list_( 64, COUNT, linear_allocator_mode::free_list, linear_allocator_growth::none, 64, linear_allocator_commit::lazy );
+	std::cout << "linear pool lazy commit: rss growth after construction=" << ( linear_resident_size( ) - rss_ ) / 1024 << " KiB; committed=" << bitmap_.committed_bytes( ) << std::endl;
+
+	// Fill half of the bitmap pool, keep every 256th block (one per 16 KiB)
+	for ( void *& block_ : blocks_ )
+		block_ = std::memset( bitmap_.allocate( ), 1, 64 );
+	std::cout << "linear pool lazy commit: committed=" << bitmap_.committed_bytes( ) / 1024 << " KiB after " << blocks_.size( ) << " blocks" << std::endl;
+	for ( std::size_t i = 0; i < blocks_.size( ); i++ )
+	{
+		if ( i % 256 != 0 )
+			bitmap_.deallocate( blocks_[i] );
+	}
+
+	// Release pages of available blocks
+	std::size_t before_( linear_resident_size( ) );
+	std::size_t released_( bitmap_.release_free_pages( ) );
+	std::cout << "linear pool bitmap release: released=" << released_ / 1024 << " KiB; rss before=" << before_ / 1024 << " KiB; after=" << linear_resident_size( ) / 1024 << " KiB" << std::endl;
+	for ( std::size_t i = 0; i < blocks_.size( ); i += 256 )
+		bitmap_.deallocate( blocks_[i] );
+
+	// Fill half of the free-list pool, keep the first 1024 blocks
+	for ( void *& block_ : blocks_ )
+		block_ = std::memset( free_list_.allocate( ), 1, 64 );
+	for ( std::size_t i = 1024; i < blocks_.size( ); i++ )
+		free_list_.deallocate( blocks_[i] );
+
+	// Release pages above the last reserved block
+	before_ = linear_resident_size( );
+	released_ = free_list_.release_free_pages( );
+	std::cout << "linear pool free_list release: released=" << released_ / 1024 << " KiB; rss before=" << before_ / 1024 << " KiB; after=" << linear_resident_size( ) / 1024 << " KiB" << std::endl;
+
+	// Released blocks are reused
+	void *const block_( free_list_.allocate( ) );
+	std::cout << "linear pool free_list reuse: first available block=" << ( block_ == blocks_[1024] ) << std::endl;
+	free_list_.deallocate( block_ );
+
+	// Deallocate kept blocks
+	for ( std::size_t i = 0; i < 1024; i++ )
+		free_list_.deallocate( blocks_[i] );
+
+}
+
+/*
+ * Linear-Pool prefault tests.
+*/
+static void linear_pool_prefault_test( )
+{
+
+	// Populated pool, 4 MiB
+	linear_pool pool_( 64, 64 * 1024, linear_allocator_mode::free_list, linear_allocator_growth::none, 64, linear_allocator_commit::populate );
+	std::vector<void*> blocks_( 64 * 1024, nullptr );
+
+	// Allocate & write all blocks
+	std::size_t faults_( linear_minor_faults( ) );
+	for ( void *& block_ : blocks_ )
+		block_ = std::memset( pool_.allocate( ), 1, 64 );
+	std::cout << "linear pool populate: minor faults=" << linear_minor_faults( ) - faults_ << " during allocation of " << blocks_.size( ) << " blocks" << std::endl;
+
+	// Release pages, prefault them again on demand
+	for ( void *const block_ : blocks_ )
+		pool_.deallocate( block_ );
+	pool_.release_free_pages( );
+	pool_.prefault( );
+	faults_ = linear_minor_faults( );
+	for ( void *& block_ : blocks_ )
+		block_ = std::memset( pool_.allocate( ), 1, 64 );
+	std::cout << "linear pool prefault: minor faults=" << linear_minor_faults( ) - faults_ << " after release & prefault" << std::endl;
+
+	// Deallocate
+	for ( void *const block_ : blocks_ )
+		pool_.deallocate( block_ );
+
+}
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+
+/*
+ * Linear-Depot tests.
+*/
+static void linear_depot_test( )
+{
+
+	// Create linear_depot instance
+	linear_depot depot_( sizeof( double ), 256 );
+
+	// Allocate & deallocate in 4 threads, each with own magazine
+	std::vector<std::thread> threads_;
+	for ( int i = 0; i < 4; i++ )
+	{
+		threads_.emplace_back( [&depot_]( )
+		{
+			linear_depot::magazine magazine_( depot_ );
+			for ( int j = 0; j < 1000; j++ )
+			{
+				double *const n_ = static_cast<double*>( magazine_.allocate( ) );
+				*n_ = j * 0.5;
+				magazine_.deallocate( n_ );
+			}
+		} );
+	}
+
+	// Wait
+	for ( std::thread & thread_ : threads_ )
+		thread_.join( );
+
+	// Print depot state
+	std::cout << "linear depot reserved blocks=" << depot_.reserved_size( ) << "; transfers=" << depot_.transfers( ) << " after 4 threads" << std::endl;
+
 }
 
+/*
+ * Takes all blocks of the pool & checks, that capacity of distinct blocks comes back.
+ *
+ * @thread_safety - pool owner thread only.
+*/
+template <typename POOL>
+static void linear_pool_drain_check( POOL & pPool, const char *const pName )
+{
+
+	// Take all blocks, one more than capacity is tried
+	std::vector<void*> blocks_;
+	while ( blocks_.size( ) <= pPool.capacity( ) )
+	{
+		void *const block_( pPool.try_allocate( ) );
+		if ( block_ == nullptr )
+			break;
+		blocks_.push_back( block_ );
+	}
+
+	// Check distinct blocks count
+	std::vector<void*> sorted_( blocks_ );
+	std::sort( sorted_.begin( ), sorted_.end( ) );
+	check( blocks_.size( ) == pPool.capacity( ) && std::unique( sorted_.begin( ), sorted_.end( ) ) == sorted_.end( ), pName );
+
+	// Deallocate
+	for ( void *const block_ : blocks_ )
+		pPool.deallocate( block_ );
+
+}
+
+/*
+ * Linear-Atomic-Pool stress check.
+ *
+ * (?) 4 threads allocate, write & verify batches of blocks, block given to 2 threads
+ * is overwritten. Half of each batch is freed by other thread.
+*/
+static void linear_atomic_pool_stress( const linear_allocator_mode pMode, const char *const pName )
+{
+
+	// Create linear_atomic_pool instance, 4 threads hold up to 48 blocks each
+	linear_atomic_pool pool_( 4 * sizeof( std::uint64_t ), 256, pMode );
+
+	// Blocks, passed to other thread for free
+	std::mutex mutex_;
+	std::vector<void*> passed_;
+
+	// Allocate, write, verify & deallocate in 4 threads
+	std::atomic<int> errors_( 0 );
+	std::vector<std::thread> threads_;
+	for ( std::uint64_t t = 0; t < 4; t++ )
+	{
+		threads_.emplace_back( [&pool_, &mutex_, &passed_, &errors_, t]( )
+		{
+			void * blocks_[32];
+			std::vector<void*> taken_;
+			for ( std::uint64_t j = 0; j < 500; j++ )
+			{
+
+				// Allocate & write thread tag
+				const std::uint64_t tag_( t << 32 | j );
+				for ( void *& block_ : blocks_ )
+				{
+					block_ = pool_.allocate( );
+					std::uint64_t *const words_( static_cast<std::uint64_t*>( block_ ) );
+					for ( int w = 0; w < 4; w++ )
+						words_[w] = tag_;
+				}
+
+				// Verify
+				for ( void *const block_ : blocks_ )
+				{
+					const std::uint64_t *const words_( static_cast<const std::uint64_t*>( block_ ) );
+					for ( int w = 0; w < 4; w++ )
+					{
+						if ( words_[w] != tag_ )
+							errors_++;
+					}
+				}
+
+				// Free first half, pass second half & take blocks of other thread
+				for ( int i = 0; i < 16; i++ )
+					pool_.deallocate( blocks_[i] );
+				{
+					std::lock_guard<std::mutex> lock_( mutex_ );
+					taken_.swap( passed_ );
+					passed_.assign( blocks_ + 16, blocks_ + 32 );
+				}
+				for ( void *const block_ : taken_ )
+					pool_.deallocate( block_ );
+				taken_.clear( );
+
+			}
+		} );
+	}
+
+	// Wait
+	for ( std::thread & thread_ : threads_ )
+		thread_.join( );
+
+	// Deallocate last passed blocks
+	for ( void *const block_ : passed_ )
+		pool_.deallocate( block_ );
+
+	// Check blocks & drain
+	check( errors_ == 0, pName );
+	linear_pool_drain_check( pool_, pName );
+
+}
+
+/*
+ * Linear-Atomic-Pool tests.
+*/
+static void linear_atomic_pool_test( )
+{
+
+	// Create linear_atomic_pool instance
+	linear_atomic_pool pool_( sizeof( double ), 256 );
+
+	// Allocate & deallocate in 4 threads
+	std::vector<std::thread> threads_;
+	for ( int i = 0; i < 4; i++ )
+	{
+		threads_.emplace_back( [&pool_]( )
+		{
+			for ( int j = 0; j < 1000; j++ )
+			{
+				double *const n_ = static_cast<double*>( pool_.allocate( ) );
+				*n_ = j * 0.5;
+				pool_.deallocate( n_ );
+			}
+		} );
+	}
+
+	// Wait
+	for ( std::thread & thread_ : threads_ )
+		thread_.join( );
+
+	// Print blocks count
+	std::cout << "linear atomic pool capacity=" << pool_.capacity( ) << " after 4 threads" << std::endl;
+
+	// Create linear_atomic_pool instance in bitmap mode
+	linear_atomic_pool bitmap_( sizeof( double ), 100, linear_allocator_mode::bitmap );
+
+	// Allocate 2 objects
+	void *const first_ = bitmap_.allocate( );
+	void *const second_ = bitmap_.allocate( );
+
+	// Print reserved blocks count
+	std::cout << "linear atomic pool bitmap reserved blocks=" << bitmap_.reserved_size( ) << " after allocation of 2 objects" << std::endl;
+
+	// Deallocate
+	bitmap_.deallocate( second_ );
+	bitmap_.deallocate( first_ );
+
+	// Stress both modes
+	linear_atomic_pool_stress( linear_allocator_mode::free_list, "linear atomic pool free-list stress" );
+	linear_atomic_pool_stress( linear_allocator_mode::bitmap, "linear atomic pool bitmap stress" );
+
+}
+
+/*
+ * Linear-Owned-Pool stress check.
+ *
+ * (?) Owner allocates & writes batch, which 4 threads verify & free remotely,
+ * while owner allocates, verifies & frees own blocks, draining remote frees.
+*/
+static void linear_owned_pool_stress( )
+{
+
+	// Create linear_owned_pool instance, this thread is owner
+	linear_owned_pool pool_( 4 * sizeof( std::uint64_t ), 256 );
+
+	// Rounds of remote & own frees
+	std::atomic<int> errors_( 0 );
+	for ( std::uint64_t j = 0; j < 200; j++ )
+	{
+
+		// Allocate & write batch for 4 threads
+		void * blocks_[128];
+		for ( std::uint64_t i = 0; i < 128; i++ )
+		{
+			blocks_[i] = pool_.allocate( );
+			std::uint64_t *const words_( static_cast<std::uint64_t*>( blocks_[i] ) );
+			for ( int w = 0; w < 4; w++ )
+				words_[w] = i << 32 | j;
+		}
+
+		// Verify & free batch in 4 threads
+		std::vector<std::thread> threads_;
+		for ( std::uint64_t t = 0; t < 4; t++ )
+		{
+			threads_.emplace_back( [&pool_, &blocks_, &errors_, j, t]( )
+			{
+				for ( std::uint64_t i = t * 32; i < t * 32 + 32; i++ )
+				{
+					const std::uint64_t *const words_( static_cast<const std::uint64_t*>( blocks_[i] ) );
+					for ( int w = 0; w < 4; w++ )
+					{
+						if ( words_[w] != ( i << 32 | j ) )
+							errors_++;
+					}
+					pool_.deallocate( blocks_[i] );
+				}
+			} );
+		}
+
+		// Allocate, write, verify & free own blocks meanwhile
+		for ( int k = 0; k < 8; k++ )
+		{
+			void * own_[64];
+			const std::uint64_t tag_( std::uint64_t( 1 ) << 63 | static_cast<std::uint64_t>( k ) << 32 | j );
+			for ( void *& block_ : own_ )
+			{
+				block_ = pool_.allocate( );
+				std::uint64_t *const words_( static_cast<std::uint64_t*>( block_ ) );
+				for ( int w = 0; w < 4; w++ )
+					words_[w] = tag_;
+			}
+			for ( void *const block_ : own_ )
+			{
+				const std::uint64_t *const words_( static_cast<const std::uint64_t*>( block_ ) );
+				for ( int w = 0; w < 4; w++ )
+				{
+					if ( words_[w] != tag_ )
+						errors_++;
+				}
+				pool_.deallocate( block_ );
+			}
+		}
+
+		// Wait
+		for ( std::thread & thread_ : threads_ )
+			thread_.join( );
+
+	}
+
+	// Check blocks & drain
+	check( errors_ == 0, "linear owned pool remote free stress" );
+	linear_pool_drain_check( pool_, "linear owned pool remote free stress" );
+
+}
+
+/*
+ * Linear-Owned-Pool tests.
+*/
+static void linear_owned_pool_test( )
+{
+
+	// Create linear_owned_pool instance, this thread is owner
+	linear_owned_pool pool_( sizeof( double ), 16 );
+
+	// Allocate all blocks
+	void * blocks_[16];
+	for ( void *& block_ : blocks_ )
+		block_ = pool_.allocate( );
+
+	// Free blocks in other thread
+	std::thread thread_( [&pool_, &blocks_]( )
+	{
+		for ( void *const block_ : blocks_ )
+			pool_.deallocate( block_ );
+	} );
+	thread_.join( );
+
+	// Allocate again, remote frees are drained
+	for ( void *& block_ : blocks_ )
+		block_ = pool_.allocate( );
+
+	// Print drains count
+	std::cout << "linear owned pool drains=" << pool_.drains( ) << " after remote frees of 16 blocks" << std::endl;
+
+	// Free blocks in owner thread
+	for ( void *const block_ : blocks_ )
+		pool_.deallocate( block_ );
+
+	// Stress remote frees
+	linear_owned_pool_stress( );
+
+}
+
+/*
+ * Linear-Sharded-Pool tests.
+*/
+static void linear_sharded_pool_test( )
+{
+
+	// Create linear_sharded_pool instance, 4 shards of 4 blocks
+	linear_sharded_pool pool_( sizeof( double ), 4, 4 );
+
+	// Allocate more blocks, than one shard has
+	void * blocks_[8];
+	for ( void *& block_ : blocks_ )
+		block_ = pool_.allocate( );
+
+	// Print steals count
+	std::cout << "linear sharded pool cpu shard=" << pool_.current_shard( ) << "; steals=" << pool_.steals( ) << " after allocation of 8 objects" << std::endl;
+
+	// Deallocate
+	for ( void *const block_ : blocks_ )
+		pool_.deallocate( block_ );
+
+	// Create linear_sharded_pool instance, shards are bound to NUMA nodes of their CPUs
+	linear_sharded_pool numa_pool_( sizeof( double ), 4, 0, alignof( double ), true );
+
+	// Allocate & touch 1 object
+	double *const n_ = static_cast<double*>( numa_pool_.allocate( ) );
+	*n_ = 777.7;
+
+	// Print policy & node of the page, reported by kernel
+	std::cout << "linear sharded pool numa shard node=" << numa_pool_.shard_node( numa_pool_.current_shard( ) ) << "; page policy bind=" << ( linear_numa_policy_of( n_ ) == LINEAR_NUMA_MPOL_BIND ) << "; page node=" << linear_numa_node_of( n_ ) << std::endl;
+
+	// Deallocate
+	numa_pool_.deallocate( n_ );
+
+	// Map 2 nodes, CPUs interleaved between nodes, to 2 & 6 shards, CPU must get shard of its node
+	int cpuNodes_[64];
+	for ( int i = 0; i < 64; i++ )
+		cpuNodes_[i] = ( i / 8 ) % 2;
+	for ( const std::size_t shards_ : { std::size_t( 1 ), std::size_t( 2 ), std::size_t( 6 ), std::size_t( 64 ) } )
+	{
+		std::size_t cpuShards_[64];
+		int shardNodes_[64];
+		bool mapped_( linear_sharded_pool::map_cpus( cpuNodes_, 64, shards_, cpuShards_, shardNodes_ ) );
+		std::size_t used_[64] = { };
+		for ( int i = 0; mapped_ && i < 64; i++ )
+		{
+			mapped_ = cpuShards_[i] < shards_ && ( shards_ < 2 || shardNodes_[cpuShards_[i]] == cpuNodes_[i] );
+			used_[mapped_ ? cpuShards_[i] : 0]++;
+		}
+		for ( std::size_t s = 0; mapped_ && s < shards_; s++ )
+			mapped_ = used_[s] == 64 / shards_ || used_[s] == 64 / shards_ + 1;
+		check( mapped_, "linear sharded pool cpu shards of own node" );
+	}
+
+}
+
+/*
+ * Linear-Heap tests.
+*/
+static void linear_heap_test( )
+{
+
+	// Create linear_heap instance, 1 MiB of each class
+	linear_heap heap_( 1024 * 1024 );
+
+	// Thread cache
+	linear_heap::cache cache_ = { };
+
+	// Allocate through cache, request above the largest class isn't served
+	void *const small_( heap_.try_allocate( cache_, 24 ) );
+	void *const large_( heap_.try_allocate( cache_, 4096 ) );
+
+	// Print usable size
+	std::cout << "linear heap usable size of 24 bytes=" << heap_.usable_size( small_ ) << "; 4096 bytes served=" << ( large_ != nullptr ) << std::endl;
+
+	// Deallocate, foreign block isn't accepted
+	int foreign_( 0 );
+	std::cout << "linear heap owns block=" << heap_.deallocate( cache_, small_, 24 ) << "; owns foreign=" << heap_.deallocate( cache_, &foreign_ ) << std::endl;
+
+	// Return cached blocks to pools
+	heap_.flush( cache_ );
+
+}
+
+#endif // MULTITHREADING
+
 /* MAIN */
 int main( int argC, char** argV )
 {
@@ -57,8 +952,52 @@ int main( int argC, char** argV )
 	// Print 'Hello Linear Allocator' to the console
 	std::cout << "Hello Linear Allocator" << std::endl;
 	
+	// Run linear_bitmap tests
+	linear_bitmap_test<false>( "linear flat bitmap" );
+	linear_bitmap_test<true>( "linear summary bitmap" );
+
 	// Run linear_allocator tests
 	linear_allocator_test( );
+	linear_allocator_alignment_test( );
+	linear_allocator_containers_test( );
+
+	// Run linear_arena tests
+	linear_arena_test( );
+
+	// Run linear_stack tests
+	linear_stack_test( );
+
+	// Run linear_frame tests
+	linear_frame_test( );
+
+	// Run linear_resource tests
+	linear_resource_test( );
+
+	// Run linear_small_allocator tests
+	linear_small_allocator_test( );
+
+	// Run linear_pool lazy commit tests
+	linear_pool_commit_test( );
+
+	// Run linear_pool prefault tests
+	linear_pool_prefault_test( );
+
+#ifdef _C0DE4UN_MULTITHREADING_ENABLED_ // MULTITHREADING
+	// Run linear_depot tests
+	linear_depot_test( );
+
+	// Run linear_atomic_pool tests
+	linear_atomic_pool_test( );
+
+	// Run linear_owned_pool tests
+	linear_owned_pool_test( );
+
+	// Run linear_sharded_pool tests
+	linear_sharded_pool_test( );
+
+	// Run linear_heap tests
+	linear_heap_test( );
+#endif // MULTITHREADING
 
 	// Print 'Linear Allocator Test Complete' to the console
 	std::cout << "Linear Allocator Test Complete, press any key to exit" << std::endl;
@@ -66,7 +1005,7 @@ int main( int argC, char** argV )
 	// Pause Console-Window
 	std::cin.get( );
 
-	// Return OK
-	return( 0 );
+	// Return failed checks
+	return( failures_ > 0 ? 1 : 0 );
 
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+/*
+ * Allocation-heavy test program, run with & without linear_malloc shim.
+ *
+ * (?) Program calls malloc/free & new/delete directly, without linear headers,
+ * so shim is the only difference between runs.
+ *
+ * Usage: linear_allocator_malloc_workload [threads]
+*/
+
+/* WORKLOAD REQUIRED HEADERS */
+
+#include <iostream> // cout
+#include <cstdlib> // malloc, free, atoi
+#include <cstddef> // size_t
+#include <chrono> // steady_clock
+#include <random> // mt19937
+#include <vector> // vector
+#include <map> // map
+#include <string> // string
+#include <thread> // thread
+
+/* END OF WORKLOAD REQUIRED HEADERS */
+
+// ===========================================================
+// Utils
+// ===========================================================
+
+/* Clock */
+using bench_clock = std::chrono::steady_clock;
+
+/* Runs the given function in the given number of threads & returns nanoseconds per operation */
+template <typename F>
+static double threads_ns_per_op( const std::size_t pThreads, const std::size_t pOps, F pFunction )
+{
+
+	// Threads
+	std::vector<std::thread> threads_;
+	threads_.reserve( pThreads );
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	// Run
+	for ( std::size_t i = 0; i < pThreads; i++ )
+		threads_.emplace_back( pFunction, i );
+	for ( std::thread & thread_ : threads_ )
+		thread_.join( );
+
+	// Return nanoseconds per operation of one thread
+	return( std::chrono::duration<double, std::nano>( bench_clock::now( ) - start_ ).count( ) / static_cast<double>( pOps ) );
+
+}
+
+// ===========================================================
+// Workloads
+// ===========================================================
+
+/*
+ * Random live block is replaced by block of random size.
+ *
+ * (?) Most sizes are small, every 64th is up to 4 KiB.
+*/
+static void churn( const std::size_t pThread )
+{
+
+	// Iterations & live blocks
+	constexpr std::size_t ITERATIONS = 2000000;
+	constexpr std::size_t LIVE = 1024;
+
+	// Random sizes
+	std::mt19937 random_( static_cast<std::mt19937::result_type>( pThread + 1 ) );
+
+	// Live blocks
+	void * blocks_[LIVE] = { };
+
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		const std::size_t slot_( random_( ) % LIVE );
+		const std::size_t size_( i % 64 == 0 ? random_( ) % 4096 + 1 : random_( ) % 256 + 1 );
+		std::free( blocks_[slot_] );
+		blocks_[slot_] = std::malloc( size_ );
+		static_cast<char*>( blocks_[slot_] )[0] = 1;
+	}
+
+	// Release live blocks
+	for ( void * block_ : blocks_ )
+		std::free( block_ );
+
+}
+
+/* Map of strings: insertion & erase of nodes */
+static void containers( const std::size_t pThread )
+{
+
+	// Iterations & keys
+	constexpr std::size_t ITERATIONS = 200000;
+	constexpr int KEYS = 4096;
+
+	// Map
+	std::mt19937 random_( static_cast<std::mt19937::result_type>( pThread + 1 ) );
+	std::map<int, std::string> map_;
+
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		const int key_( static_cast<int>( random_( ) % KEYS ) );
+		if ( ( i & 1 ) == 0 )
+			map_[key_] = std::string( 24 + key_ % 40, 'x' );
+		else
+			map_.erase( key_ );
+	}
+
+}
+
+/* Blocks, allocated by one thread, are deallocated by other */
+static void cross_thread( const std::size_t pThreads )
+{
+
+	// Blocks per thread & rounds
+	constexpr std::size_t BLOCKS = 100000;
+	constexpr std::size_t ROUNDS = 10;
+
+	// Blocks of threads
+	std::vector<std::vector<void*>> blocks_( pThreads, std::vector<void*>( BLOCKS, nullptr ) );
+
+	for ( std::size_t round_ = 0; round_ < ROUNDS; round_++ )
+	{
+
+		// Each thread frees blocks of the previous thread & allocates own
+		std::vector<std::thread> threads_;
+		for ( std::size_t t = 0; t < pThreads; t++ )
+		{
+			threads_.emplace_back( [&blocks_, pThreads, t, round_]( )
+			{
+				std::vector<void*> & victim_( blocks_[( t + round_ ) % pThreads] );
+				for ( void *& block_ : victim_ )
+				{
+					std::free( block_ );
+					block_ = std::malloc( 16 + ( reinterpret_cast<std::size_t>( &block_ ) >> 3 ) % 128 );
+				}
+			} );
+		}
+		for ( std::thread & thread_ : threads_ )
+			thread_.join( );
+
+	}
+
+	// Release blocks
+	for ( std::vector<void*> & thread_blocks_ : blocks_ )
+		for ( void * block_ : thread_blocks_ )
+			std::free( block_ );
+
+}
+
+/* MAIN */
+int main( int argC, char** argV )
+{
+
+	// Threads count
+	const std::size_t threads_( argC > 1 && std::atoi( argV[1] ) > 0 ? static_cast<std::size_t>( std::atoi( argV[1] ) ) : 4 );
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	// Workloads
+	std::cout << "churn: " << threads_ns_per_op( threads_, 2000000, churn ) << " ns/op" << std::endl;
+	std::cout << "containers: " << threads_ns_per_op( threads_, 200000, containers ) << " ns/op" << std::endl;
+	const bench_clock::time_point cross_start_ = bench_clock::now( );
+	cross_thread( threads_ );
+	std::cout << "cross-thread: " << std::chrono::duration<double, std::nano>( bench_clock::now( ) - cross_start_ ).count( ) / ( 100000.0 * 10 * threads_ ) << " ns/op" << std::endl;
+
+	// Print total time
+	std::cout << "total: " << std::chrono::duration<double, std::milli>( bench_clock::now( ) - start_ ).count( ) << " ms; threads=" << threads_ << std::endl;
+
+	// Return OK
+	return( 0 );
+
+}
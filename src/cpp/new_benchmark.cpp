@@ -0,0 +1,170 @@
+/*
+ * Copyright  2018 Denis Zyamaev. Email: (code4un@yandex.ru)
+ * License: see "LICENSE" file
+ * Author: Denis Zyamaev (code4un@yandex.ru)
+ * API: C++ 17
+*/
+
+/*
+ * Benchmark of operator new & operator delete, replaced by linear_new.cpp.
+ *
+ * (?) Program is linked with linear_new.cpp, malloc stays glibc & serves as reference.
+ *
+ * (?) Untimed warm-up churn faults pools pages in first. Timed rounds then alternate
+ * order of sized & unsized delete, so neither pays first touch, best round is printed.
+*/
+
+/* NEW BENCHMARK REQUIRED HEADERS */
+
+#include <iostream> // cout
+#include <cstdlib> // malloc, free
+#include <cstddef> // size_t
+#include <new> // new, delete
+#include <chrono> // steady_clock
+#include <random> // mt19937
+#include <vector> // vector
+
+/* END OF NEW BENCHMARK REQUIRED HEADERS */
+
+// ===========================================================
+// Utils
+// ===========================================================
+
+/* Clock */
+using bench_clock = std::chrono::steady_clock;
+
+/* Iterations */
+static constexpr std::size_t ITERATIONS = 4000000;
+
+/* Live blocks */
+static constexpr std::size_t LIVE = 4096;
+
+/* Timed rounds */
+static constexpr int ROUNDS = 4;
+
+/* Node of 48 bytes, deleted with sized delete */
+struct node
+{
+	node * next_;
+	double values_[5];
+};
+
+/* Returns nanoseconds per operation since the given time-point */
+static double ns_per_op( const bench_clock::time_point & pStart, const std::size_t pOps )
+{ return( std::chrono::duration<double, std::nano>( bench_clock::now( ) - pStart ).count( ) / static_cast<double>( pOps ) ); }
+
+/*
+ * Random live block is replaced by block of random size up to 512 bytes.
+ *
+ * @param F - allocation function.
+ * @param D - deallocation function, gets block & its size.
+ * @return - nanoseconds per operation.
+*/
+template <typename F, typename D>
+static double churn( const std::vector<std::size_t> & pSizes, const std::vector<std::size_t> & pSlots, F pAllocate, D pDeallocate )
+{
+
+	// Live blocks & sizes
+	std::vector<void*> blocks_( LIVE, nullptr );
+	std::vector<std::size_t> sizes_( LIVE, 0 );
+
+	// Start
+	const bench_clock::time_point start_ = bench_clock::now( );
+
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		const std::size_t slot_( pSlots[i] );
+		if ( blocks_[slot_] != nullptr )
+			pDeallocate( blocks_[slot_], sizes_[slot_] );
+		blocks_[slot_] = pAllocate( pSizes[i] );
+		sizes_[slot_] = pSizes[i];
+	}
+
+	// Time
+	const double result_( ns_per_op( start_, ITERATIONS ) );
+
+	// Release live blocks
+	for ( std::size_t i = 0; i < LIVE; i++ )
+	{
+		if ( blocks_[i] != nullptr )
+			pDeallocate( blocks_[i], sizes_[i] );
+	}
+
+	// Return time
+	return( result_ );
+
+}
+
+/* MAIN */
+int main( int argC, char** argV )
+{
+
+	// Print 'linear_new benchmarks' to the console
+	std::cout << "linear_new benchmarks" << std::endl;
+
+	// Random sizes & slots
+	std::mt19937 random_( 42 );
+	std::vector<std::size_t> sizes_( ITERATIONS );
+	std::vector<std::size_t> slots_( ITERATIONS );
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		sizes_[i] = random_( ) % 512 + 1;
+		slots_[i] = random_( ) % LIVE;
+	}
+
+	// Sized delete, class from the size; unsized delete, class from the address; glibc malloc
+	const auto new_ = []( const std::size_t pSize ) { return( ::operator new( pSize ) ); };
+	const auto sizedDelete_ = []( void *const ptr_, const std::size_t pSize ) { ::operator delete( ptr_, pSize ); };
+	const auto unsizedDelete_ = []( void *const ptr_, const std::size_t ) { ::operator delete( ptr_ ); };
+	const auto malloc_ = []( const std::size_t pSize ) { return( std::malloc( pSize ) ); };
+	const auto free_ = []( void *const ptr_, const std::size_t ) { std::free( ptr_ ); };
+
+	// Untimed warm-up
+	churn( sizes_, slots_, new_, sizedDelete_ );
+	churn( sizes_, slots_, malloc_, free_ );
+
+	// Timed rounds, sized & unsized delete alternate order, best round is kept
+	double sized_( 0 );
+	double unsized_( 0 );
+	double glibc_( 0 );
+	for ( int round_ = 0; round_ < ROUNDS; round_++ )
+	{
+		double sizedRound_;
+		double unsizedRound_;
+		if ( round_ % 2 == 0 )
+		{
+			sizedRound_ = churn( sizes_, slots_, new_, sizedDelete_ );
+			unsizedRound_ = churn( sizes_, slots_, new_, unsizedDelete_ );
+		}
+		else
+		{
+			unsizedRound_ = churn( sizes_, slots_, new_, unsizedDelete_ );
+			sizedRound_ = churn( sizes_, slots_, new_, sizedDelete_ );
+		}
+		const double glibcRound_( churn( sizes_, slots_, malloc_, free_ ) );
+		sized_ = round_ == 0 || sizedRound_ < sized_ ? sizedRound_ : sized_;
+		unsized_ = round_ == 0 || unsizedRound_ < unsized_ ? unsizedRound_ : unsized_;
+		glibc_ = round_ == 0 || glibcRound_ < glibc_ ? glibcRound_ : glibc_;
+	}
+
+	// Print results
+	std::cout << "operator new/sized delete: " << sized_ << " ns/op" << std::endl;
+	std::cout << "operator new/unsized delete: " << unsized_ << " ns/op" << std::endl;
+	std::cout << "malloc/free: " << glibc_ << " ns/op" << std::endl;
+
+	// Node objects, delete expression of complete type calls sized delete
+	std::vector<node*> nodes_( LIVE, nullptr );
+	const bench_clock::time_point start_ = bench_clock::now( );
+	for ( std::size_t i = 0; i < ITERATIONS; i++ )
+	{
+		delete nodes_[slots_[i]];
+		nodes_[slots_[i]] = new node( );
+	}
+	std::cout << "new/delete node: " << ns_per_op( start_, ITERATIONS ) << " ns/op" << std::endl;
+	for ( node *const node_ : nodes_ )
+		delete node_;
+
+	// Return OK
+	return( 0 );
+
+}